@@ -0,0 +1,72 @@
+// Measures heap allocations and time per reassignment of a Result holding a
+// std::string or std::vector. Assigning over a Result that already holds the
+// same alternative reuses the existing buffer.
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "result/result.h"
+
+using namespace result;
+
+static std::size_t g_allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++g_allocations;
+    if(void* ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+template <typename R>
+void run(const char* name, R& target, const R& source) {
+    constexpr std::size_t iterations = 1000000;
+    std::size_t allocations = g_allocations;
+    double ns = bench::ns_per_iteration(iterations, [&] {
+        target = source;
+        bench::do_not_optimize(target);
+    });
+    std::printf("%-48s %10.2f ns %8.3f allocations/assign\n",
+            name,
+            ns,
+            static_cast<double>(g_allocations - allocations) / iterations);
+}
+
+int main() {
+    const std::string text(256, 'x');
+    const std::vector<int> values(256, 1);
+
+    {
+        using R = Result<std::string, int>;
+        R target = Ok(text);
+        R ok = Ok(text);
+        R err = Err(1);
+        run("Result<string, int> Ok = Ok", target, ok);
+
+        // Alternates kinds so every assignment destroys and reconstructs.
+        R flip[2] = {ok, err};
+        std::size_t allocations = g_allocations;
+        double ns = bench::ns_per_iteration(1000000, [&, i = 0]() mutable {
+            target = flip[i ^= 1];
+            bench::do_not_optimize(target);
+        });
+        std::printf("%-48s %10.2f ns %8.3f allocations/assign\n",
+                "Result<string, int> alternating Ok/Err",
+                ns,
+                static_cast<double>(g_allocations - allocations) / 1000000);
+    }
+    {
+        using R = Result<std::vector<int>, int>;
+        R target = Ok(values);
+        R ok = Ok(values);
+        run("Result<vector<int>, int> Ok = Ok", target, ok);
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+#ifndef RESULT_BENCH_H_5c0d2f7e_1a4b_4e8e_9a43_63f2d1c7b0a9
+#define RESULT_BENCH_H_5c0d2f7e_1a4b_4e8e_9a43_63f2d1c7b0a9
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+
+// Keeps the compiler from optimizing away the computation of `value`.
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Calls `fn` `iterations` times and returns the mean time per call in
+// nanoseconds.
+template <typename F>
+double ns_per_iteration(std::size_t iterations, F&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for(std::size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+            static_cast<double>(iterations);
+}
+
+inline void report(const char* name, double ns) {
+    std::printf("%-48s %10.2f ns\n", name, ns);
+}
+
+// Counts last-level cache misses of the calling thread with perf_event_open.
+// Reports -1 where the counter is unavailable, e.g. outside Linux or when
+// perf_event_paranoid forbids it.
+class CacheMisses {
+public:
+    CacheMisses() {
+#if defined(__linux__)
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+    ~CacheMisses() {
+#if defined(__linux__)
+        if(m_fd >= 0) {
+            close(m_fd);
+        }
+#endif
+    }
+    CacheMisses(const CacheMisses&) = delete;
+    CacheMisses& operator=(const CacheMisses&) = delete;
+
+    void start() {
+#if defined(__linux__)
+        if(m_fd >= 0) {
+            ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+    std::int64_t stop() {
+#if defined(__linux__)
+        std::uint64_t count = 0;
+        if(m_fd >= 0) {
+            ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+            if(read(m_fd, &count, sizeof(count)) == sizeof(count)) {
+                return static_cast<std::int64_t>(count);
+            }
+        }
+#endif
+        return -1;
+    }
+
+private:
+    int m_fd = -1;
+};
+
+} // namespace bench
+
+#endif
@@ -0,0 +1,85 @@
+// Scans a vector of mostly-Ok results and sums the Ok values, once with the
+// error stored inline and once boxed. The boxed layout is a fraction of the
+// size, so the scan touches fewer cache lines.
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "result/boxed.h"
+#include "result/result.h"
+
+using namespace result;
+
+namespace {
+
+struct MyError {
+    enum class ErrorKind { OutOfDomain };
+
+    MyError(ErrorKind kind, std::string reason = "")
+        : kind(kind), reason(std::move(reason)) {}
+
+    bool operator==(const MyError& other) const {
+        return kind == other.kind && reason == other.reason;
+    }
+
+    ErrorKind kind;
+    std::string reason;
+};
+
+constexpr std::size_t count = 1 << 22;
+constexpr std::size_t error_every = 1000;
+
+template <typename E>
+std::vector<Result<int, E>> make_results() {
+    std::vector<Result<int, E>> results;
+    results.reserve(count);
+    for(std::size_t i = 0; i < count; ++i) {
+        if(i % error_every == 0) {
+            results.emplace_back(err_tag,
+                    MyError(MyError::ErrorKind::OutOfDomain, "out of domain"));
+        } else {
+            results.emplace_back(ok_tag, static_cast<int>(i));
+        }
+    }
+    return results;
+}
+
+template <typename E>
+void run(const char* name) {
+    auto results = make_results<E>();
+    bench::CacheMisses misses;
+
+    std::int64_t sum = 0;
+    misses.start();
+    double ns = bench::ns_per_iteration(10, [&] {
+        for(const auto& result : results) {
+            if(result.is_ok()) {
+                sum += result.ok_unchecked();
+            }
+        }
+        bench::do_not_optimize(sum);
+    });
+    std::int64_t miss_count = misses.stop();
+
+    std::printf("%-32s %3zu bytes/result %8.3f ns/result ",
+            name,
+            sizeof(Result<int, E>),
+            ns / count);
+    if(miss_count >= 0) {
+        std::printf("%8.4f cache misses/result\n",
+                static_cast<double>(miss_count) / (10.0 * count));
+    } else {
+        std::printf("   cache misses n/a\n");
+    }
+}
+
+} // namespace
+
+int main() {
+    run<MyError>("Result<int, MyError>");
+    run<Boxed<MyError>>("Result<int, Boxed<MyError>>");
+    return 0;
+}
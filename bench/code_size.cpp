@@ -0,0 +1,163 @@
+// Reports the bytes of hot .text per `unwrap` call site.
+//
+// Each site is a separate noinline function. "before" sites spell out what
+// `unwrap` used to inline: the kind check followed by the std::cerr message
+// and std::terminate. "after" sites call `unwrap()`, whose panic path is an
+// out-of-line cold function. The sizes come from the executable's own symbol
+// table; code that GCC moves to .text.unlikely is listed separately under a
+// `.cold` symbol and is not counted as hot.
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <elf.h>
+#endif
+
+#include "bench.h"
+#include "result/result.h"
+
+using namespace result;
+
+namespace {
+
+using R = Result<long, int>;
+using S = Result<std::string, int>;
+
+template <typename T, typename E>
+__attribute__((always_inline)) inline T unwrap_before(Result<T, E>&& result) {
+    if(!result.is_ok()) {
+        std::cerr << "Called `unwrap` on an Err value" << std::endl;
+        std::terminate();
+    }
+    return std::move(result).ok_unchecked();
+}
+
+} // namespace
+
+// The sites differ by a constant so that identical code folding cannot merge
+// them.
+#define RESULT_SITES(N)                                                        \
+    extern "C" __attribute__((noinline)) long before_long_##N(R r) {           \
+        return unwrap_before(std::move(r)) + N;                                \
+    }                                                                          \
+    extern "C" __attribute__((noinline)) long after_long_##N(R r) {            \
+        return std::move(r).unwrap() + N;                                      \
+    }                                                                          \
+    extern "C" __attribute__((noinline)) std::size_t before_string_##N(S s) {  \
+        return unwrap_before(std::move(s)).size() + N;                         \
+    }                                                                          \
+    extern "C" __attribute__((noinline)) std::size_t after_string_##N(S s) {   \
+        return std::move(s).unwrap().size() + N;                               \
+    }
+
+RESULT_SITES(0)
+RESULT_SITES(1)
+RESULT_SITES(2)
+RESULT_SITES(3)
+RESULT_SITES(4)
+RESULT_SITES(5)
+RESULT_SITES(6)
+RESULT_SITES(7)
+
+#undef RESULT_SITES
+
+namespace {
+
+constexpr int sites = 8;
+
+struct Symbol {
+    std::string name;
+    std::size_t size;
+};
+
+// Reads the function symbols of the running executable.
+std::vector<Symbol> read_symbols() {
+    std::vector<Symbol> symbols;
+#if defined(__linux__) && defined(__LP64__)
+    std::ifstream file("/proc/self/exe", std::ios::binary);
+    std::vector<char> image(
+            (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if(image.size() < sizeof(Elf64_Ehdr)) {
+        return symbols;
+    }
+    Elf64_Ehdr header;
+    std::memcpy(&header, image.data(), sizeof(header));
+    for(int i = 0; i < header.e_shnum; ++i) {
+        Elf64_Shdr section;
+        std::memcpy(&section,
+                image.data() + header.e_shoff + i * header.e_shentsize,
+                sizeof(section));
+        if(section.sh_type != SHT_SYMTAB) {
+            continue;
+        }
+        Elf64_Shdr strings;
+        std::memcpy(&strings,
+                image.data() + header.e_shoff +
+                        section.sh_link * header.e_shentsize,
+                sizeof(strings));
+        for(std::size_t offset = 0; offset < section.sh_size;
+                offset += sizeof(Elf64_Sym)) {
+            Elf64_Sym symbol;
+            std::memcpy(&symbol,
+                    image.data() + section.sh_offset + offset,
+                    sizeof(symbol));
+            if(ELF64_ST_TYPE(symbol.st_info) == STT_FUNC) {
+                symbols.push_back(
+                        {image.data() + strings.sh_offset + symbol.st_name,
+                                symbol.st_size});
+            }
+        }
+    }
+#endif
+    return symbols;
+}
+
+// Sums the sizes of the `prefix_N` site functions and of their `.cold`
+// parts.
+void report(const std::vector<Symbol>& symbols, const char* prefix) {
+    std::size_t hot = 0;
+    std::size_t cold = 0;
+    int found = 0;
+    for(int i = 0; i < sites; ++i) {
+        std::string name = prefix + std::to_string(i);
+        for(const Symbol& symbol : symbols) {
+            if(symbol.name == name) {
+                hot += symbol.size;
+                ++found;
+            } else if(symbol.name == name + ".cold") {
+                cold += symbol.size;
+            }
+        }
+    }
+    if(found != sites) {
+        std::printf("%-48s %10s\n", prefix, "n/a");
+        return;
+    }
+    std::printf("%-48s %7.1f B/site hot %7.1f B/site cold\n",
+            prefix,
+            static_cast<double>(hot) / sites,
+            static_cast<double>(cold) / sites);
+}
+
+} // namespace
+
+int main() {
+    // Keep every site referenced.
+    R ok(ok_tag, 1);
+    S text(ok_tag, "text");
+    bench::do_not_optimize(before_long_0(ok) + after_long_0(ok) +
+            before_string_0(text) + after_string_0(text));
+
+    std::vector<Symbol> symbols = read_symbols();
+    report(symbols, "before_long_");
+    report(symbols, "after_long_");
+    report(symbols, "before_string_");
+    report(symbols, "after_string_");
+    return 0;
+}
@@ -0,0 +1,50 @@
+// Measures how long the compiler takes on compile_time_tu.cpp, a translation
+// unit that uses the common Result types, with and without the extern
+// templates of result/extern.h, at -O0 and -O2. The compiler and paths are
+// those of the build, passed in by bench/CMakeLists.txt.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+constexpr int runs = 10;
+
+// Returns the mean wall time of compiling the unit in milliseconds, or a
+// negative value if the compiler failed.
+double compile_ms(const std::string& flags) {
+    const std::string command = std::string(RESULT_BENCH_CXX) +
+            " -std=c++17 -I" RESULT_BENCH_SOURCE_DIR " " + flags +
+            " -c " RESULT_BENCH_SOURCE_DIR "/bench/compile_time_tu.cpp" +
+            " -o " RESULT_BENCH_BINARY_DIR "/compile_time_tu.o";
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < runs; ++i) {
+        if(std::system(command.c_str()) != 0) {
+            return -1;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() /
+            runs;
+}
+
+void run(const char* name, const std::string& flags) {
+    double ms = compile_ms(flags);
+    if(ms < 0) {
+        std::printf("%-48s %10s\n", name, "failed");
+    } else {
+        std::printf("%-48s %10.1f ms\n", name, ms);
+    }
+}
+
+} // namespace
+
+int main() {
+    run("-O0, implicit instantiation", "-O0");
+    run("-O0, extern templates", "-O0 -DRESULT_EXTERN_TEMPLATES");
+    run("-O2, implicit instantiation", "-O2");
+    run("-O2, extern templates", "-O2 -DRESULT_EXTERN_TEMPLATES");
+    return 0;
+}
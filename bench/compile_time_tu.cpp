@@ -0,0 +1,45 @@
+// The translation unit compiled by bench_compile_time. It uses the common
+// Result types the way ordinary code does: construction, copies and moves,
+// queries, comparisons and the unwrap family.
+
+#include <cstdint>
+#include <string>
+#include <system_error>
+
+#include "result/result.h"
+
+using namespace result;
+
+namespace {
+
+template <typename R>
+auto use(R r, const R& other) {
+    R copy = r;
+    copy = other;
+    R moved = std::move(copy);
+    bool same = r.is_ok() && !r.is_err() && r == other;
+    auto value = r.clone().unwrap_or_default();
+    auto error = other.clone().unwrap_err_or_default();
+    (void)error;
+    if(same) {
+        return std::move(moved).expect("unreachable");
+    }
+    return value;
+}
+
+} // namespace
+
+#define RESULT_BENCH_USE(name, T, E)                                           \
+    T name##_1(Result<T, E> a, const Result<T, E>& b) { return use(a, b); }    \
+    T name##_2(Result<T, E> a, const Result<T, E>& b) {                        \
+        return use(std::move(a), b);                                           \
+    }                                                                          \
+    T name##_3(const Result<T, E>& a) { return a.unwrap_or(T()); }             \
+    E name##_4(const Result<T, E>& a) { return a.unwrap_err_or(E()); }
+
+RESULT_BENCH_USE(unit_int, unit_t, int)
+RESULT_BENCH_USE(status, unit_t, std::error_code)
+RESULT_BENCH_USE(int_string, int, std::string)
+RESULT_BENCH_USE(int64_code, std::int64_t, std::error_code)
+RESULT_BENCH_USE(string_string, std::string, std::string)
+RESULT_BENCH_USE(string_code, std::string, std::error_code)
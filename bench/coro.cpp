@@ -0,0 +1,103 @@
+// Propagates a result through a chain of five functions four ways: with
+// explicit is_err() checks, with PROPAGATE, with RESULT_TRY, and as
+// coroutines using co_await. The coroutine version pays for one frame allocation per level,
+// because GCC does not elide coroutine frames; Clang can, since the handle
+// never escapes the promise.
+
+#include <cstdio>
+#include <string>
+
+#include "bench.h"
+#include "result/coro.h"
+#include "result/result.h"
+
+using namespace result;
+
+namespace {
+
+struct Error {
+    std::string message;
+    int code;
+};
+
+using R = Result<long, Error>;
+
+constexpr std::size_t iterations = 1000000;
+
+__attribute__((noinline)) R leaf(long x) {
+    if(x < 0) {
+        return R(err_tag,
+                Error{"input was negative, which this function rejects", 1});
+    }
+    return R(ok_tag, x + 1);
+}
+
+template <int N>
+__attribute__((noinline)) R with_checks(long x) {
+    R result = with_checks<N - 1>(x);
+    if(result.is_err()) {
+        return R(err_tag, std::move(result).err_unchecked());
+    }
+    return R(ok_tag, std::move(result).ok_unchecked() + 1);
+}
+template <>
+R with_checks<0>(long x) {
+    return leaf(x);
+}
+
+// PROPAGATE declares its own `r`, so the result needs a different name.
+template <int N>
+__attribute__((noinline)) R with_propagate(long x) {
+    R result = with_propagate<N - 1>(x);
+    PROPAGATE(result);
+    return R(ok_tag, std::move(result).unwrap_unchecked() + 1);
+}
+template <>
+R with_propagate<0>(long x) {
+    return leaf(x);
+}
+
+template <int N>
+__attribute__((noinline)) R with_try(long x) {
+    long value = RESULT_TRY(with_try<N - 1>(x));
+    return R(ok_tag, value + 1);
+}
+template <>
+R with_try<0>(long x) {
+    return leaf(x);
+}
+
+template <int N>
+__attribute__((noinline)) R with_co_await(long x) {
+    long value = co_await with_co_await<N - 1>(x);
+    co_return value + 1;
+}
+template <>
+R with_co_await<0>(long x) {
+    return leaf(x);
+}
+
+template <typename F>
+void run(const char* name, long input, F&& fn) {
+    double ns = bench::ns_per_iteration(iterations, [&] {
+        long x = input;
+        bench::do_not_optimize(x);
+        R r = fn(x);
+        bench::do_not_optimize(r);
+    });
+    bench::report(name, ns);
+}
+
+} // namespace
+
+int main() {
+    run("is_err() checks, 5 levels, Ok", 1, with_checks<5>);
+    run("PROPAGATE, 5 levels, Ok", 1, with_propagate<5>);
+    run("RESULT_TRY, 5 levels, Ok", 1, with_try<5>);
+    run("co_await, 5 levels, Ok", 1, with_co_await<5>);
+    run("is_err() checks, 5 levels, Err", -1, with_checks<5>);
+    run("PROPAGATE, 5 levels, Err", -1, with_propagate<5>);
+    run("RESULT_TRY, 5 levels, Err", -1, with_try<5>);
+    run("co_await, 5 levels, Err", -1, with_co_await<5>);
+    return 0;
+}
@@ -0,0 +1,139 @@
+// Sums 2^16 checked values, each check a few hundred nanoseconds of hashing,
+// with the first error placed at various positions, and reports the time of:
+//
+// - a loop that checks every element and only then looks for errors,
+// - try_fold, which stops at the error,
+// - par_try_for_each and try_reduce on the shared pool, which stop starting
+//   chunks at the error,
+// - par_try_for_each with elements of 64 times the work, once ignoring the
+//   CancellationToken and once polling it between steps.
+
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "result/collect.h"
+#include "result/parallel.h"
+#include "result/result.h"
+
+using namespace result;
+
+namespace {
+
+constexpr std::size_t count = 1 << 16;
+constexpr std::size_t long_count = 1024;
+constexpr std::size_t iterations = 5;
+
+using R = Result<std::uint64_t, int>;
+
+std::uint64_t mix(std::uint64_t hash, int rounds) {
+    for(int round = 0; round < rounds; ++round) {
+        hash = (hash ^ (hash >> 29)) * 0xbf58476d1ce4e5b9u;
+    }
+    return hash;
+}
+
+struct Check {
+    std::uint64_t bad;
+
+    R operator()(std::uint64_t value) const {
+        std::uint64_t hash = mix(value, 256);
+        if(value == bad) {
+            return R(err_tag, static_cast<int>(value));
+        }
+        return R(ok_tag, hash & 0xff);
+    }
+};
+
+// Fails the element at `fraction` of the way through, or none if it is 1.
+void run(const char* position, double fraction,
+        const std::vector<std::uint64_t>& values) {
+    auto error_at = [&](std::size_t size) {
+        return fraction < 1 ? static_cast<std::uint64_t>(fraction * size)
+                            : ~std::uint64_t(0);
+    };
+    std::uint64_t bad = error_at(count);
+    Check check{bad};
+    char name[64];
+    auto report = [&](const char* how, double ns) {
+        std::snprintf(name, sizeof(name), "%s, %s", position, how);
+        bench::report(name, ns);
+    };
+
+    report("check all", bench::ns_per_iteration(iterations, [&] {
+        std::vector<R> checked;
+        checked.reserve(values.size());
+        for(std::uint64_t value : values) {
+            checked.push_back(check(value));
+        }
+        bench::do_not_optimize(collect(std::move(checked)));
+    }));
+    report("try_fold", bench::ns_per_iteration(iterations, [&] {
+        bench::do_not_optimize(try_fold(values, std::uint64_t(0),
+                [&](std::uint64_t sum, std::uint64_t value) {
+                    return check(value).map(
+                            [&](std::uint64_t x) { return sum + x; });
+                }));
+    }));
+    report("par_try_for_each", bench::ns_per_iteration(iterations, [&] {
+        bench::do_not_optimize(par_try_for_each(values, check));
+    }));
+    report("try_reduce", bench::ns_per_iteration(iterations, [&] {
+        bench::do_not_optimize(try_reduce(values, std::uint64_t(0),
+                [&](std::uint64_t sum, std::uint64_t value) {
+                    if(value == bad) {
+                        return check(value);
+                    }
+                    return R(ok_tag, sum + (mix(value, 256) & 0xff));
+                }));
+    }));
+
+    // Long elements: the error ends its own element at once, while the others
+    // run 64 steps unless they poll the token.
+    std::uint64_t long_bad = error_at(long_count);
+    auto long_check = [&](std::uint64_t value) {
+        if(value == long_bad) {
+            return R(err_tag, static_cast<int>(value));
+        }
+        return R(ok_tag, mix(value, 64 * 256));
+    };
+    auto polling_check = [&](std::uint64_t value,
+                                 const CancellationToken& token) {
+        if(value == long_bad) {
+            return R(err_tag, static_cast<int>(value));
+        }
+        std::uint64_t hash = value;
+        for(int step = 0; step < 64; ++step) {
+            if(token.is_cancelled()) {
+                return R(err_tag, -1);
+            }
+            hash = mix(hash, 256);
+        }
+        return R(ok_tag, hash);
+    };
+    const std::vector<std::uint64_t> few(
+            values.begin(), values.begin() + long_count);
+    report("long, ignoring the token", bench::ns_per_iteration(iterations, [&] {
+        bench::do_not_optimize(par_try_for_each(few, long_check));
+    }));
+    report("long, polling the token", bench::ns_per_iteration(iterations, [&] {
+        bench::do_not_optimize(par_try_for_each(few, polling_check));
+    }));
+}
+
+} // namespace
+
+int main() {
+    std::printf("%u hardware threads, %zu in the shared pool\n",
+            std::thread::hardware_concurrency(), ThreadPool::shared().size());
+    std::vector<std::uint64_t> values(count);
+    for(std::size_t i = 0; i < count; ++i) {
+        values[i] = i;
+    }
+    run("error at 1%", 0.01, values);
+    run("error at 10%", 0.1, values);
+    run("error at 50%", 0.5, values);
+    run("no error", 1, values);
+}
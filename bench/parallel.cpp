@@ -0,0 +1,68 @@
+// Validates 2^18 records, each check a few hundred nanoseconds of hashing, with
+// try_collect on one thread and par_map on the shared pool. The "early error"
+// rows fail the record at index 1000, where par_map should stop about as soon
+// as the sequential loop does.
+
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "result/collect.h"
+#include "result/parallel.h"
+#include "result/result.h"
+
+using namespace result;
+
+namespace {
+
+constexpr std::size_t count = 1 << 18;
+constexpr std::size_t iterations = 5;
+
+using R = Result<std::uint64_t, int>;
+
+struct Validate {
+    std::uint64_t bad;
+
+    R operator()(std::uint64_t record) const {
+        std::uint64_t hash = record;
+        for(int round = 0; round < 256; ++round) {
+            hash = (hash ^ (hash >> 29)) * 0xbf58476d1ce4e5b9u;
+        }
+        if(record == bad) {
+            return R(err_tag, static_cast<int>(record));
+        }
+        return R(ok_tag, hash);
+    }
+};
+
+void run(const char* name, const std::vector<std::uint64_t>& records,
+        Validate validate) {
+    char label[64];
+    std::snprintf(label, sizeof(label), "%s, try_collect", name);
+    bench::report(label, bench::ns_per_iteration(iterations, [&] {
+        bench::do_not_optimize(try_collect(records, validate));
+    }));
+    std::snprintf(label, sizeof(label), "%s, par_map", name);
+    bench::report(label, bench::ns_per_iteration(iterations, [&] {
+        bench::do_not_optimize(par_map(records, validate));
+    }));
+    std::snprintf(label, sizeof(label), "%s, par_map collect_all", name);
+    bench::report(label, bench::ns_per_iteration(iterations, [&] {
+        bench::do_not_optimize(par_map(records, validate, collect_all));
+    }));
+}
+
+} // namespace
+
+int main() {
+    std::printf("%u hardware threads, %zu in the shared pool\n",
+            std::thread::hardware_concurrency(), ThreadPool::shared().size());
+    std::vector<std::uint64_t> records(count);
+    for(std::size_t i = 0; i < count; ++i) {
+        records[i] = i;
+    }
+    run("all Ok", records, Validate{~std::uint64_t(0)});
+    run("early error", records, Validate{1000});
+}
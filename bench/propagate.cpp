@@ -0,0 +1,74 @@
+// Propagates a result through a chain of five functions, once with the old
+// PROPAGATE macro and once with RESULT_TRY. The error carries a message too
+// long for the small-string buffer, so every copy of the Result allocates.
+// Each level is kept out of line so the chain is not collapsed.
+
+#include <cstdio>
+#include <string>
+
+#include "bench.h"
+#include "result/result.h"
+
+using namespace result;
+
+namespace {
+
+struct Error {
+    std::string message;
+    int code;
+};
+
+using R = Result<long, Error>;
+
+constexpr std::size_t iterations = 1000000;
+
+__attribute__((noinline)) R leaf(long x) {
+    if(x < 0) {
+        return R(err_tag,
+                Error{"input was negative, which this function rejects", 1});
+    }
+    return R(ok_tag, x + 1);
+}
+
+// PROPAGATE declares its own `r`, so the result needs a different name.
+template <int N>
+__attribute__((noinline)) R with_propagate(long x) {
+    R result = with_propagate<N - 1>(x);
+    PROPAGATE(result);
+    return R(ok_tag, std::move(result).unwrap_unchecked() + 1);
+}
+template <>
+R with_propagate<0>(long x) {
+    return leaf(x);
+}
+
+template <int N>
+__attribute__((noinline)) R with_try(long x) {
+    long value = RESULT_TRY(with_try<N - 1>(x));
+    return R(ok_tag, value + 1);
+}
+template <>
+R with_try<0>(long x) {
+    return leaf(x);
+}
+
+template <typename F>
+void run(const char* name, long input, F&& fn) {
+    double ns = bench::ns_per_iteration(iterations, [&] {
+        long x = input;
+        bench::do_not_optimize(x);
+        R r = fn(x);
+        bench::do_not_optimize(r);
+    });
+    bench::report(name, ns);
+}
+
+} // namespace
+
+int main() {
+    run("PROPAGATE, 5 levels, Ok", 1, with_propagate<5>);
+    run("RESULT_TRY, 5 levels, Ok", 1, with_try<5>);
+    run("PROPAGATE, 5 levels, Err", -1, with_propagate<5>);
+    run("RESULT_TRY, 5 levels, Err", -1, with_try<5>);
+    return 0;
+}
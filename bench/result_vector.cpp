@@ -0,0 +1,120 @@
+// Compares scans over a million mostly-Ok results stored as a
+// std::vector<Result<std::int64_t, Error>> and as a ResultVector:
+//
+// - sum: add up the Ok values.
+// - filter: copy the Ok values above a threshold into a new vector.
+// - iterate: visit every element as a Result, Ok or not.
+//
+// Error holds a std::string, so each element of the plain vector is 48 bytes
+// where the ResultVector stores 8 bytes per Ok value and one bit per element.
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "result/result.h"
+#include "result/vector.h"
+
+using namespace result;
+
+namespace {
+
+struct Error {
+    int code;
+    std::string reason;
+};
+
+using R = Result<std::int64_t, Error>;
+
+constexpr std::size_t count = 1 << 20;
+constexpr std::size_t iterations = 20;
+
+template <typename Container>
+Container make_results(std::size_t error_every) {
+    Container results;
+    results.reserve(count);
+    for(std::size_t i = 0; i < count; ++i) {
+        if(i % error_every == 0) {
+            results.push_back(R(err_tag, Error{1, "out of range"}));
+        } else {
+            results.push_back(R(ok_tag, static_cast<std::int64_t>(i)));
+        }
+    }
+    return results;
+}
+
+void report(const char* name, double ns) {
+    std::printf("%-48s %10.3f ns/element\n", name, ns / count);
+}
+
+void run(std::size_t error_every) {
+    auto plain = make_results<std::vector<R>>(error_every);
+    auto soa = make_results<ResultVector<std::int64_t, Error>>(error_every);
+    const std::int64_t threshold = count / 2;
+    std::printf("1 error in %zu:\n", error_every);
+
+    report("  sum, std::vector<Result>",
+            bench::ns_per_iteration(iterations, [&] {
+                std::int64_t sum = 0;
+                for(const R& result : plain) {
+                    if(result.is_ok()) {
+                        sum += result.ok_unchecked();
+                    }
+                }
+                bench::do_not_optimize(sum);
+            }));
+    report("  sum, ResultVector", bench::ns_per_iteration(iterations, [&] {
+        std::int64_t sum = 0;
+        for(std::int64_t value : soa.values()) {
+            sum += value;
+        }
+        bench::do_not_optimize(sum);
+    }));
+
+    report("  filter, std::vector<Result>",
+            bench::ns_per_iteration(iterations, [&] {
+                std::vector<std::int64_t> kept;
+                for(const R& result : plain) {
+                    if(result.is_ok() && result.ok_unchecked() > threshold) {
+                        kept.push_back(result.ok_unchecked());
+                    }
+                }
+                bench::do_not_optimize(kept.data());
+            }));
+    report("  filter, ResultVector", bench::ns_per_iteration(iterations, [&] {
+        std::vector<std::int64_t> kept;
+        for(std::int64_t value : soa.values()) {
+            if(value > threshold) {
+                kept.push_back(value);
+            }
+        }
+        bench::do_not_optimize(kept.data());
+    }));
+
+    report("  iterate, std::vector<Result>",
+            bench::ns_per_iteration(iterations, [&] {
+                std::size_t errors = 0;
+                for(const R& result : plain) {
+                    errors += result.is_err() ? result.err_unchecked().code
+                                              : 0;
+                }
+                bench::do_not_optimize(errors);
+            }));
+    report("  iterate, ResultVector", bench::ns_per_iteration(iterations, [&] {
+        std::size_t errors = 0;
+        for(auto result : soa) {
+            errors += result.is_err() ? result.err_unchecked().get().code : 0;
+        }
+        bench::do_not_optimize(errors);
+    }));
+}
+
+} // namespace
+
+int main() {
+    run(1000);
+    run(10);
+    return 0;
+}
@@ -0,0 +1,547 @@
+#ifndef RESULT_BATCH_H_5d27c3a9_8e41_4f0b_a6d3_c91e07b4f582
+#define RESULT_BATCH_H_5d27c3a9_8e41_4f0b_a6d3_c91e07b4f582
+
+// Batches of arithmetic results laid out for SIMD, and kernels over them.
+//
+// The kernels pick an implementation at runtime: AVX2 or SSE2 on x86 with
+// GCC or Clang, and portable scalar code elsewhere. Define
+// `RESULT_DISABLE_SIMD` to always use the scalar code. `map_ok` takes an
+// arbitrary function and has no hand-written kernels; its plain loop is left
+// to the compiler to vectorize.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "result/result.h"
+
+#if !defined(RESULT_DISABLE_SIMD) && \
+        (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define RESULT_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace result {
+
+/// The instruction sets the batch kernels may use, from least to most capable.
+enum class SimdLevel : std::uint8_t { Scalar, SSE2, AVX2 };
+
+namespace details {
+
+inline SimdLevel detect_simd_level() noexcept {
+#if defined(RESULT_X86_SIMD)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+        return SimdLevel::AVX2;
+    }
+    if(__builtin_cpu_supports("sse2")) {
+        return SimdLevel::SSE2;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+// Negative until the first kernel runs, so that programs which never use
+// them do not pay for the detection at startup.
+inline std::atomic<int> current_simd_level{-1};
+
+} // namespace details
+
+/// The instruction set the batch kernels use: the best one the CPU supports,
+/// unless lowered by `set_simd_level`.
+inline SimdLevel simd_level() noexcept {
+    int level = details::current_simd_level.load(std::memory_order_relaxed);
+    if(level < 0) {
+        level = static_cast<int>(details::detect_simd_level());
+        details::current_simd_level.store(level, std::memory_order_relaxed);
+    }
+    return static_cast<SimdLevel>(level);
+}
+
+/// Makes the batch kernels use at most `level`, for instance to compare the
+/// implementations. Levels above what the CPU supports are lowered to it.
+inline void set_simd_level(SimdLevel level) noexcept {
+    SimdLevel supported = details::detect_simd_level();
+    details::current_simd_level.store(
+            static_cast<int>(level < supported ? level : supported),
+            std::memory_order_relaxed);
+}
+
+namespace details {
+
+enum class ReduceOp { Sum, Min, Max };
+
+template <ReduceOp Op, typename T>
+constexpr T reduce_identity() noexcept {
+    if constexpr(Op == ReduceOp::Sum) {
+        return T();
+    } else if constexpr(Op == ReduceOp::Min) {
+        return std::numeric_limits<T>::has_infinity
+                ? std::numeric_limits<T>::infinity()
+                : std::numeric_limits<T>::max();
+    } else {
+        return std::numeric_limits<T>::has_infinity
+                ? -std::numeric_limits<T>::infinity()
+                : std::numeric_limits<T>::lowest();
+    }
+}
+
+template <ReduceOp Op, typename T>
+constexpr T reduce_step(T acc, T value) noexcept {
+    if constexpr(Op == ReduceOp::Sum) {
+        return acc + value;
+    } else if constexpr(Op == ReduceOp::Min) {
+        return value < acc ? value : acc;
+    } else {
+        return value > acc ? value : acc;
+    }
+}
+
+// ===== Scalar kernels ===== {{{
+
+inline std::size_t count_ok_scalar(
+        const std::uint64_t* bits, std::size_t words) noexcept {
+    std::size_t count = 0;
+    for(std::size_t i = 0; i < words; ++i) {
+        std::uint64_t x = bits[i];
+        x = x - ((x >> 1) & 0x5555555555555555ull);
+        x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+        x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+        count += static_cast<std::size_t>((x * 0x0101010101010101ull) >> 56);
+    }
+    return count;
+}
+
+// The index of the first word with a clear bit, or `words` if there is none.
+inline std::size_t find_err_word_scalar(
+        const std::uint64_t* bits, std::size_t words) noexcept {
+    std::size_t i = 0;
+    while(i < words && bits[i] == ~std::uint64_t(0)) {
+        ++i;
+    }
+    return i;
+}
+
+// Reduces the values of the set bits of `bits[0, words)` into `acc`. Each
+// word covers 64 slots of `values`.
+template <ReduceOp Op, typename T>
+T reduce_scalar(const std::uint64_t* bits,
+        const T* values,
+        std::size_t words,
+        T acc) noexcept {
+    // Four independent accumulators, so that each step does not wait for
+    // the previous one.
+    const T identity = reduce_identity<Op, T>();
+    T lanes[4] = {identity, identity, identity, identity};
+    for(std::size_t w = 0; w < words; ++w) {
+        const std::uint64_t word = bits[w];
+        if(word == 0) {
+            continue;
+        }
+        for(std::size_t lane = 0; lane < 64; ++lane) {
+            T value = (word >> lane) & 1 ? values[w * 64 + lane] : identity;
+            lanes[lane % 4] = reduce_step<Op>(lanes[lane % 4], value);
+        }
+    }
+    for(T lane : lanes) {
+        acc = reduce_step<Op>(acc, lane);
+    }
+    return acc;
+}
+
+template <typename T, typename F>
+void map_scalar(T* values, std::size_t count, F& fn) {
+    for(std::size_t i = 0; i < count; ++i) {
+        values[i] = fn(values[i]);
+    }
+}
+
+// }}}
+
+#if defined(RESULT_X86_SIMD)
+
+// ===== SSE2 kernels ===== {{{
+
+__attribute__((target("sse2"))) inline std::size_t count_ok_sse2(
+        const std::uint64_t* bits, std::size_t words) noexcept {
+    const __m128i m1 = _mm_set1_epi8(0x55);
+    const __m128i m2 = _mm_set1_epi8(0x33);
+    const __m128i m4 = _mm_set1_epi8(0x0f);
+    __m128i acc = _mm_setzero_si128();
+    std::size_t i = 0;
+    for(; i + 2 <= words; i += 2) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bits + i));
+        x = _mm_sub_epi8(x, _mm_and_si128(_mm_srli_epi64(x, 1), m1));
+        x = _mm_add_epi8(_mm_and_si128(x, m2),
+                _mm_and_si128(_mm_srli_epi64(x, 2), m2));
+        x = _mm_and_si128(_mm_add_epi8(x, _mm_srli_epi64(x, 4)), m4);
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(x, _mm_setzero_si128()));
+    }
+    std::uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return static_cast<std::size_t>(lanes[0] + lanes[1]) +
+            count_ok_scalar(bits + i, words - i);
+}
+
+__attribute__((target("sse2"))) inline std::size_t find_err_word_sse2(
+        const std::uint64_t* bits, std::size_t words) noexcept {
+    const __m128i ones = _mm_set1_epi32(-1);
+    std::size_t i = 0;
+    for(; i + 2 <= words; i += 2) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bits + i));
+        if(_mm_movemask_epi8(_mm_cmpeq_epi32(x, ones)) != 0xffff) {
+            break;
+        }
+    }
+    return i + find_err_word_scalar(bits + i, words - i);
+}
+
+template <ReduceOp Op>
+__attribute__((target("sse2"))) inline double reduce_sse2(
+        const std::uint64_t* bits,
+        const double* values,
+        std::size_t words,
+        double acc) noexcept {
+    // Lane masks for the four combinations of two bits.
+    alignas(16) static const std::uint64_t masks[4][2] = {
+            {0, 0}, {~0ull, 0}, {0, ~0ull}, {~0ull, ~0ull}};
+    const __m128d identity = _mm_set1_pd(reduce_identity<Op, double>());
+    __m128d a = _mm_set1_pd(reduce_identity<Op, double>());
+    __m128d b = a;
+    for(std::size_t w = 0; w < words; ++w) {
+        const std::uint64_t word = bits[w];
+        if(word == 0) {
+            continue;
+        }
+        const double* block = values + w * 64;
+        for(std::size_t j = 0; j < 64; j += 4) {
+            __m128d lo_mask = _mm_load_pd(
+                    reinterpret_cast<const double*>(masks[(word >> j) & 3]));
+            __m128d hi_mask = _mm_load_pd(reinterpret_cast<const double*>(
+                    masks[(word >> (j + 2)) & 3]));
+            __m128d lo = _mm_loadu_pd(block + j);
+            __m128d hi = _mm_loadu_pd(block + j + 2);
+            if constexpr(Op == ReduceOp::Sum) {
+                a = _mm_add_pd(a, _mm_and_pd(lo_mask, lo));
+                b = _mm_add_pd(b, _mm_and_pd(hi_mask, hi));
+            } else {
+                lo = _mm_or_pd(_mm_and_pd(lo_mask, lo),
+                        _mm_andnot_pd(lo_mask, identity));
+                hi = _mm_or_pd(_mm_and_pd(hi_mask, hi),
+                        _mm_andnot_pd(hi_mask, identity));
+                if constexpr(Op == ReduceOp::Min) {
+                    a = _mm_min_pd(a, lo);
+                    b = _mm_min_pd(b, hi);
+                } else {
+                    a = _mm_max_pd(a, lo);
+                    b = _mm_max_pd(b, hi);
+                }
+            }
+        }
+    }
+    alignas(16) double lanes[4];
+    _mm_store_pd(lanes, a);
+    _mm_store_pd(lanes + 2, b);
+    for(double lane : lanes) {
+        acc = reduce_step<Op>(acc, lane);
+    }
+    return acc;
+}
+
+// }}}
+
+// ===== AVX2 kernels ===== {{{
+
+__attribute__((target("avx2,popcnt"))) inline std::size_t count_ok_avx2(
+        const std::uint64_t* bits, std::size_t words) noexcept {
+    // Counts the bits of each nibble with a lookup table.
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2,
+            3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0f);
+    __m256i acc = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for(; i + 4 <= words; i += 4) {
+        __m256i x = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(bits + i));
+        __m256i counts = _mm256_add_epi8(
+                _mm256_shuffle_epi8(table, _mm256_and_si256(x, low)),
+                _mm256_shuffle_epi8(
+                        table, _mm256_and_si256(_mm256_srli_epi16(x, 4), low)));
+        acc = _mm256_add_epi64(
+                acc, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+    }
+    std::uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    std::size_t count =
+            static_cast<std::size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    for(; i < words; ++i) {
+        count += static_cast<std::size_t>(_mm_popcnt_u64(bits[i]));
+    }
+    return count;
+}
+
+__attribute__((target("avx2"))) inline std::size_t find_err_word_avx2(
+        const std::uint64_t* bits, std::size_t words) noexcept {
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    std::size_t i = 0;
+    for(; i + 4 <= words; i += 4) {
+        __m256i x = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(bits + i));
+        if(_mm256_movemask_epi8(_mm256_cmpeq_epi64(x, ones)) != -1) {
+            break;
+        }
+    }
+    return i + find_err_word_scalar(bits + i, words - i);
+}
+
+template <ReduceOp Op>
+__attribute__((target("avx2"))) inline double reduce_avx2(
+        const std::uint64_t* bits,
+        const double* values,
+        std::size_t words,
+        double acc) noexcept {
+    const __m256i lane_bits = _mm256_setr_epi64x(1, 2, 4, 8);
+    const __m256d identity = _mm256_set1_pd(reduce_identity<Op, double>());
+    __m256d a = identity;
+    __m256d b = identity;
+    for(std::size_t w = 0; w < words; ++w) {
+        const std::uint64_t word = bits[w];
+        if(word == 0) {
+            continue;
+        }
+        const double* block = values + w * 64;
+        for(std::size_t j = 0; j < 64; j += 8) {
+            // Spreads bits j..j+3 and j+4..j+7 over the four lanes.
+            __m256i lo_bits = _mm256_set1_epi64x(
+                    static_cast<long long>((word >> j) & 0xf));
+            __m256i hi_bits = _mm256_set1_epi64x(
+                    static_cast<long long>((word >> (j + 4)) & 0xf));
+            __m256d lo_mask = _mm256_castsi256_pd(_mm256_cmpeq_epi64(
+                    _mm256_and_si256(lo_bits, lane_bits), lane_bits));
+            __m256d hi_mask = _mm256_castsi256_pd(_mm256_cmpeq_epi64(
+                    _mm256_and_si256(hi_bits, lane_bits), lane_bits));
+            __m256d lo = _mm256_loadu_pd(block + j);
+            __m256d hi = _mm256_loadu_pd(block + j + 4);
+            if constexpr(Op == ReduceOp::Sum) {
+                a = _mm256_add_pd(a, _mm256_and_pd(lo_mask, lo));
+                b = _mm256_add_pd(b, _mm256_and_pd(hi_mask, hi));
+            } else {
+                lo = _mm256_blendv_pd(identity, lo, lo_mask);
+                hi = _mm256_blendv_pd(identity, hi, hi_mask);
+                if constexpr(Op == ReduceOp::Min) {
+                    a = _mm256_min_pd(a, lo);
+                    b = _mm256_min_pd(b, hi);
+                } else {
+                    a = _mm256_max_pd(a, lo);
+                    b = _mm256_max_pd(b, hi);
+                }
+            }
+        }
+    }
+    alignas(32) double lanes[8];
+    _mm256_store_pd(lanes, a);
+    _mm256_store_pd(lanes + 4, b);
+    for(double lane : lanes) {
+        acc = reduce_step<Op>(acc, lane);
+    }
+    return acc;
+}
+
+// }}}
+
+#endif
+
+inline std::size_t count_ok(
+        const std::uint64_t* bits, std::size_t words) noexcept {
+#if defined(RESULT_X86_SIMD)
+    switch(simd_level()) {
+    case SimdLevel::AVX2:
+        return count_ok_avx2(bits, words);
+    case SimdLevel::SSE2:
+        return count_ok_sse2(bits, words);
+    case SimdLevel::Scalar:
+        break;
+    }
+#endif
+    return count_ok_scalar(bits, words);
+}
+
+inline std::size_t find_err_word(
+        const std::uint64_t* bits, std::size_t words) noexcept {
+#if defined(RESULT_X86_SIMD)
+    switch(simd_level()) {
+    case SimdLevel::AVX2:
+        return find_err_word_avx2(bits, words);
+    case SimdLevel::SSE2:
+        return find_err_word_sse2(bits, words);
+    case SimdLevel::Scalar:
+        break;
+    }
+#endif
+    return find_err_word_scalar(bits, words);
+}
+
+template <ReduceOp Op, typename T>
+T reduce(const std::uint64_t* bits, const T* values, std::size_t words) {
+    T acc = reduce_identity<Op, T>();
+#if defined(RESULT_X86_SIMD)
+    if constexpr(std::is_same<T, double>::value) {
+        switch(simd_level()) {
+        case SimdLevel::AVX2:
+            return reduce_avx2<Op>(bits, values, words, acc);
+        case SimdLevel::SSE2:
+            return reduce_sse2<Op>(bits, values, words, acc);
+        case SimdLevel::Scalar:
+            break;
+        }
+    }
+#endif
+    return reduce_scalar<Op>(bits, values, words, acc);
+}
+
+} // namespace details
+
+/// A batch of `Result<T, E>` for an arithmetic `T`, stored as an array with a
+/// slot for every element and a bitmap of which elements are `Ok`. Errors are
+/// only recorded as such; keep their payloads elsewhere if they matter.
+///
+/// The slots of `Err` elements hold unspecified values. Since every slot is
+/// a `T`, the kernels can process whole vectors of slots and mask out the
+/// errors afterwards:
+///
+///     ResultBatch<double> batch;
+///     for(double x : inputs) {
+///         batch.push_back(checked_log(x));
+///     }
+///     batch.map_ok([](double x) { return x * 0.5 + 1.0; });
+///     double total = batch.sum_ok();
+template <typename T>
+class ResultBatch {
+    static_assert(std::is_arithmetic<T>::value,
+            "ResultBatch<T> requires an arithmetic T");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    ResultBatch() = default;
+
+    size_type size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    void reserve(size_type count) {
+        m_values.reserve((count + 63) / 64 * 64);
+        m_ok_bits.reserve((count + 63) / 64);
+    }
+    void clear() noexcept {
+        m_values.clear();
+        m_ok_bits.clear();
+        m_size = 0;
+    }
+
+    void push_ok(T value) {
+        push_slot(value);
+        m_ok_bits.back() |= std::uint64_t(1) << ((m_size - 1) % 64);
+    }
+    void push_err() { push_slot(T()); }
+    template <typename E>
+    void push_back(const Result<T, E>& result) {
+        if(details::hint_ok<E>(result.is_ok())) {
+            push_ok(result.ok_unchecked());
+        } else {
+            push_err();
+        }
+    }
+
+    bool is_ok(size_type index) const noexcept {
+        return (m_ok_bits[index / 64] >> (index % 64)) & 1;
+    }
+    bool is_err(size_type index) const noexcept { return !is_ok(index); }
+    Result<T, unit_t> operator[](size_type index) const noexcept {
+        if(is_ok(index)) {
+            return Result<T, unit_t>(ok_tag, m_values[index]);
+        }
+        return Result<T, unit_t>(err_tag);
+    }
+
+    /// Every slot, `Ok` or not. The array is padded to a multiple of 64.
+    const T* values() const noexcept { return m_values.data(); }
+    /// The bitmap of `Ok` elements, one bit per element starting from the
+    /// least significant bit of the first word. Bits past `size()` are clear.
+    const std::uint64_t* ok_bits() const noexcept { return m_ok_bits.data(); }
+
+    size_type count_ok() const noexcept {
+        return details::count_ok(m_ok_bits.data(), m_ok_bits.size());
+    }
+    /// The index of the first `Err`, or `size()` if there is none.
+    size_type find_first_err() const noexcept {
+        size_type word =
+                details::find_err_word(m_ok_bits.data(), m_ok_bits.size());
+        if(word == m_ok_bits.size()) {
+            return size();
+        }
+        size_type lane = 0;
+        while((m_ok_bits[word] >> lane) & 1) {
+            ++lane;
+        }
+        size_type index = word * 64 + lane;
+        return index < size() ? index : size();
+    }
+
+    /// Replaces each `Ok` value `x` with `fn(x)`. `fn` is applied to the
+    /// slots of `Err` elements too and must accept any value of `T`, so that
+    /// the loop has no branches and the compiler can vectorize simple
+    /// arithmetic. It does not depend on `simd_level()`.
+    template <typename F>
+    void map_ok(F&& fn) {
+        details::map_scalar(m_values.data(), m_size, fn);
+    }
+
+    /// The sum of the `Ok` values, or zero if there are none.
+    T sum_ok() const { return reduce<details::ReduceOp::Sum>(); }
+    /// The smallest `Ok` value, or nothing if there are no `Ok` elements.
+    std::optional<T> min_ok() const {
+        return extremum<details::ReduceOp::Min>();
+    }
+    /// The largest `Ok` value, or nothing if there are no `Ok` elements.
+    std::optional<T> max_ok() const {
+        return extremum<details::ReduceOp::Max>();
+    }
+
+private:
+    // Appends a slot. The slots are allocated 64 at a time, one word of the
+    // bitmap, so the kernels never need a scalar tail.
+    void push_slot(T value) {
+        if(m_size % 64 == 0) {
+            m_ok_bits.push_back(0);
+            m_values.resize(m_values.size() + 64);
+        }
+        m_values[m_size++] = value;
+    }
+
+    template <details::ReduceOp Op>
+    T reduce() const {
+        return details::reduce<Op>(
+                m_ok_bits.data(), m_values.data(), m_ok_bits.size());
+    }
+    template <details::ReduceOp Op>
+    std::optional<T> extremum() const {
+        if(count_ok() == 0) {
+            return std::nullopt;
+        }
+        return reduce<Op>();
+    }
+
+    std::vector<T> m_values;
+    std::vector<std::uint64_t> m_ok_bits;
+    size_type m_size = 0;
+};
+
+} // namespace result
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef RESULT_BOXED_H_8f3e6a12_4c5d_4b7e_a1f0_2d9c8b7e6f51
+#define RESULT_BOXED_H_8f3e6a12_4c5d_4b7e_a1f0_2d9c8b7e6f51
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "result/result.h"
+
+namespace result {
+
+namespace details {
+
+// A per-thread free list of fixed-size blocks. Blocks freed on another thread
+// simply join that thread's list. Each list is capped so that a burst of errors
+// does not pin memory forever.
+template <std::size_t Size, std::size_t Align>
+class BoxPool {
+    union Node {
+        Node* next;
+        alignas(Align) unsigned char storage[Size];
+    };
+
+    static constexpr std::size_t max_free = 64;
+
+public:
+    static void* allocate() {
+        State& state = current();
+        if(state.head) {
+            Node* node = state.head;
+            state.head = node->next;
+            --state.count;
+            return node->storage;
+        }
+        return ::operator new(sizeof(Node));
+    }
+
+    static void deallocate(void* ptr) noexcept {
+        State& state = current();
+        if(state.count < max_free) {
+            Node* node = static_cast<Node*>(ptr);
+            node->next = state.head;
+            state.head = node;
+            ++state.count;
+        } else {
+            ::operator delete(ptr);
+        }
+    }
+
+private:
+    // The list itself is trivially destructible so that it stays usable while
+    // other thread_local objects are destroyed. `Drain` empties it at thread
+    // exit and stops it from caching blocks afterwards.
+    struct State {
+        Node* head;
+        std::size_t count;
+    };
+
+    struct Drain {
+        ~Drain() {
+            State& state = s_state;
+            while(state.head) {
+                Node* next = state.head->next;
+                ::operator delete(state.head);
+                state.head = next;
+            }
+            state.count = max_free;
+        }
+    };
+
+    static thread_local State s_state;
+    static thread_local Drain s_drain;
+
+    // Registers s_drain's destructor for the calling thread.
+    static State& current() noexcept {
+        (void)&s_drain;
+        return s_state;
+    }
+};
+
+template <std::size_t Size, std::size_t Align>
+thread_local typename BoxPool<Size, Align>::State BoxPool<Size, Align>::s_state =
+        {nullptr, 0};
+template <std::size_t Size, std::size_t Align>
+thread_local typename BoxPool<Size, Align>::Drain BoxPool<Size, Align>::s_drain;
+
+} // namespace details
+
+/// An error kept out of line, behind a pointer to a block from a per-thread
+/// pool.
+///
+/// Large error types make every `Result` that can hold them large, even
+/// though errors are rare. `Result<T, Boxed<E>>` only needs room for `T`, a
+/// pointer and the tag, which keeps the hot success path compact. A `Boxed<E>`
+/// is never null except after it has been moved from, or as the niche of a
+/// `Status`; copying a null `Boxed` gives a null `Boxed`.
+template <typename E>
+class Boxed {
+    using Pool = details::BoxPool<sizeof(E), alignof(E)>;
+
+public:
+    using value_type = E;
+
+    Boxed(const E& value) : m_ptr(make(value)) {}
+    Boxed(E&& value) : m_ptr(make(std::move(value))) {}
+    template <typename... Args>
+    explicit Boxed(std::in_place_t, Args&&... args)
+        : m_ptr(make(std::forward<Args>(args)...)) {}
+
+    Boxed(const Boxed& other)
+        : m_ptr(other.m_ptr ? make(*other) : nullptr) {}
+    Boxed(Boxed&& other) noexcept : m_ptr(other.m_ptr) {
+        other.m_ptr = nullptr;
+    }
+    Boxed& operator=(const Boxed& other) {
+        if(!other.m_ptr) {
+            reset();
+        } else if(!m_ptr) {
+            m_ptr = make(*other);
+        } else if(this != &other) {
+            **this = *other;
+        }
+        return *this;
+    }
+    Boxed& operator=(Boxed&& other) noexcept {
+        std::swap(m_ptr, other.m_ptr);
+        return *this;
+    }
+
+    ~Boxed() { reset(); }
+
+    const E& operator*() const noexcept { return *m_ptr; }
+    E& operator*() noexcept { return *m_ptr; }
+    const E* operator->() const noexcept { return m_ptr; }
+    E* operator->() noexcept { return m_ptr; }
+
+    const E& get() const noexcept { return *m_ptr; }
+    E& get() noexcept { return *m_ptr; }
+
+    /// Compares the boxed errors. An empty (moved-from) `Boxed` only equals
+    /// another empty one.
+    bool operator==(const Boxed& other) const {
+        if(!m_ptr || !other.m_ptr) {
+            return m_ptr == other.m_ptr;
+        }
+        return **this == *other;
+    }
+    bool operator!=(const Boxed& other) const { return !(*this == other); }
+
+private:
+    friend struct niche_traits<Boxed<E>>;
+
+    struct null_t {};
+    explicit Boxed(null_t) noexcept : m_ptr(nullptr) {}
+
+    void reset() noexcept {
+        if(m_ptr) {
+            m_ptr->~E();
+            Pool::deallocate(m_ptr);
+            m_ptr = nullptr;
+        }
+    }
+
+    template <typename... Args>
+    static E* make(Args&&... args) {
+        void* ptr = Pool::allocate();
+        try {
+            return new(ptr) E(std::forward<Args>(args)...);
+        } catch(...) {
+            Pool::deallocate(ptr);
+            throw;
+        }
+    }
+
+    E* m_ptr;
+};
+
+/// The null pointer of a `Boxed<E>` is its niche, so `Status<Boxed<E>>` is the
+/// size of a pointer.
+template <typename E>
+struct niche_traits<Boxed<E>> {
+    static constexpr bool has_niche = true;
+
+    static Boxed<E> niche_value() noexcept {
+        return Boxed<E>(typename Boxed<E>::null_t{});
+    }
+    static bool is_niche(const Boxed<E>& value) noexcept {
+        return value.m_ptr == nullptr;
+    }
+};
+
+} // namespace result
+
+#endif
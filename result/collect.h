@@ -0,0 +1,232 @@
+#ifndef RESULT_COLLECT_H_a41c7e05_93d2_4f6b_8e1a_5c0b72d8f394
+#define RESULT_COLLECT_H_a41c7e05_93d2_4f6b_8e1a_5c0b72d8f394
+
+// Algorithms over ranges of `Result`s:
+//
+// - `collect` turns a range of `Result<T, E>` into a `Result<Container, E>`
+//   holding every value, or the first error.
+// - `try_collect` does the same for the results of calling a function on
+//   each element of a range.
+// - `partition` splits a range of `Result<T, E>` into its values and its
+//   errors.
+// - `try_for_each` and `try_fold` call a function returning a `Result` on each
+//   element in turn, for its effects or to accumulate a value, and stop at the
+//   first error.
+//
+// Each takes either a range or a pair of iterators. Elements of an rvalue
+// range are moved from; pass `std::make_move_iterator`s to move from a pair
+// of iterators.
+
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "result/result.h"
+
+namespace result {
+namespace details {
+
+template <typename T, typename = void>
+struct has_reserve : std::false_type {};
+template <typename T>
+struct has_reserve<T,
+        std::void_t<decltype(std::declval<T&>().reserve(std::size_t()))>>
+    : std::true_type {};
+
+// Reserves room for the elements in [first, last) when the count is known
+// without walking the range.
+template <typename Container, typename It, typename Sentinel>
+void reserve_for(Container& container, const It& first, const Sentinel& last) {
+    if constexpr(has_reserve<Container>::value &&
+            std::is_same<It, Sentinel>::value &&
+            std::is_base_of<std::random_access_iterator_tag,
+                    typename std::iterator_traits<
+                            It>::iterator_category>::value) {
+        container.reserve(static_cast<std::size_t>(last - first));
+    }
+}
+
+// `Container`, or `std::vector<T>` if it is void.
+template <typename Container, typename T>
+using container_or_vector = std::conditional_t<std::is_void<Container>::value,
+        std::vector<T>,
+        Container>;
+
+template <typename Range>
+auto range_begin(Range&& range) {
+    using std::begin;
+    if constexpr(std::is_lvalue_reference<Range>::value) {
+        return begin(range);
+    } else {
+        return std::make_move_iterator(begin(range));
+    }
+}
+template <typename Range>
+auto range_end(Range&& range) {
+    using std::end;
+    if constexpr(std::is_lvalue_reference<Range>::value) {
+        return end(range);
+    } else {
+        return std::make_move_iterator(end(range));
+    }
+}
+
+template <typename It>
+using element_result = std::remove_cv_t<
+        std::remove_reference_t<decltype(*std::declval<It>())>>;
+
+} // namespace details
+
+/// Collects the values of the `Result`s in [first, last) into a `Container`,
+/// `std::vector<T>` by default. Stops at the first `Err` and returns it.
+///
+///     std::vector<Result<int, ParseError>> parsed = ...;
+///     Result<std::vector<int>, ParseError> all = collect(std::move(parsed));
+///     Result<std::set<int>, ParseError> set = collect<std::set<int>>(parsed);
+template <typename Container = void, typename It, typename Sentinel>
+auto collect(It first, Sentinel last) {
+    using R = details::element_result<It>;
+    using C = details::container_or_vector<Container, typename R::value_type>;
+    using E = typename R::error_type;
+
+    C values;
+    details::reserve_for(values, first, last);
+    for(; first != last; ++first) {
+        auto&& result = *first;
+        if(details::hint_err<E>(result.is_err())) {
+            return Result<C, E>(err_tag,
+                    std::forward<decltype(result)>(result).err_unchecked());
+        }
+        values.insert(values.end(),
+                std::forward<decltype(result)>(result).ok_unchecked());
+    }
+    return Result<C, E>(ok_tag, std::move(values));
+}
+template <typename Container = void, typename Range>
+auto collect(Range&& range) {
+    return collect<Container>(details::range_begin(std::forward<Range>(range)),
+            details::range_end(std::forward<Range>(range)));
+}
+
+/// Calls `fn` on each element of [first, last) and collects the values of
+/// the `Result`s it returns, like `collect`. `fn` is not called again after
+/// it returns an `Err`.
+///
+///     Result<std::vector<int>, ParseError> numbers =
+///             try_collect(lines, parse);
+template <typename Container = void, typename It, typename Sentinel,
+        typename F>
+auto try_collect(It first, Sentinel last, F&& fn) {
+    using R = std::invoke_result_t<F&, decltype(*first)>;
+    using C = details::container_or_vector<Container, typename R::value_type>;
+    using E = typename R::error_type;
+
+    C values;
+    details::reserve_for(values, first, last);
+    for(; first != last; ++first) {
+        R result = std::invoke(fn, *first);
+        if(details::hint_err<E>(result.is_err())) {
+            return Result<C, E>(err_tag, std::move(result).err_unchecked());
+        }
+        values.insert(values.end(), std::move(result).ok_unchecked());
+    }
+    return Result<C, E>(ok_tag, std::move(values));
+}
+template <typename Container = void, typename Range, typename F>
+auto try_collect(Range&& range, F&& fn) {
+    return try_collect<Container>(
+            details::range_begin(std::forward<Range>(range)),
+            details::range_end(std::forward<Range>(range)),
+            std::forward<F>(fn));
+}
+
+/// Splits the `Result`s in [first, last) into their values and their errors,
+/// each kept in order, in a single pass.
+///
+///     auto [values, errors] = partition(std::move(parsed));
+template <typename It, typename Sentinel>
+auto partition(It first, Sentinel last) {
+    using R = details::element_result<It>;
+    using T = typename R::value_type;
+    using E = typename R::error_type;
+
+    std::pair<std::vector<T>, std::vector<E>> parts;
+    if constexpr(ok_is_likely<E>::value) {
+        details::reserve_for(parts.first, first, last);
+    }
+    for(; first != last; ++first) {
+        auto&& result = *first;
+        if(details::hint_ok<E>(result.is_ok())) {
+            parts.first.push_back(
+                    std::forward<decltype(result)>(result).ok_unchecked());
+        } else {
+            parts.second.push_back(
+                    std::forward<decltype(result)>(result).err_unchecked());
+        }
+    }
+    return parts;
+}
+template <typename Range>
+auto partition(Range&& range) {
+    return partition(details::range_begin(std::forward<Range>(range)),
+            details::range_end(std::forward<Range>(range)));
+}
+
+/// Calls `fn` on each element of [first, last) until it returns an `Err`, and
+/// returns `Status<E>`: that error, or `Ok` if there was none.
+///
+///     Status<IoError> sent = try_for_each(messages, send);
+template <typename It, typename Sentinel, typename F>
+auto try_for_each(It first, Sentinel last, F&& fn) {
+    using R = std::invoke_result_t<F&, decltype(*first)>;
+    using E = typename R::error_type;
+
+    for(; first != last; ++first) {
+        R result = std::invoke(fn, *first);
+        if(details::hint_err<E>(result.is_err())) {
+            return Status<E>(err_tag, std::move(result).err_unchecked());
+        }
+    }
+    return Status<E>(ok_tag);
+}
+template <typename Range, typename F>
+auto try_for_each(Range&& range, F&& fn) {
+    return try_for_each(details::range_begin(std::forward<Range>(range)),
+            details::range_end(std::forward<Range>(range)),
+            std::forward<F>(fn));
+}
+
+/// Folds [first, last) into an accumulator, starting from `init`, with
+/// `fn(acc, element) -> Result<Acc, E>`. Stops at the first `Err` and returns
+/// it.
+///
+///     Result<std::uint32_t, Overflow> total = try_fold(sizes,
+///             std::uint32_t(0), checked_add);
+template <typename It, typename Sentinel, typename Acc, typename F>
+auto try_fold(It first, Sentinel last, Acc init, F&& fn) {
+    using R = std::invoke_result_t<F&, Acc, decltype(*first)>;
+    using E = typename R::error_type;
+    static_assert(std::is_same<typename R::value_type, Acc>::value,
+            "try_fold needs a function returning Result<Acc, E>");
+
+    for(; first != last; ++first) {
+        R result = std::invoke(fn, std::move(init), *first);
+        if(details::hint_err<E>(result.is_err())) {
+            return Result<Acc, E>(err_tag, std::move(result).err_unchecked());
+        }
+        init = std::move(result).ok_unchecked();
+    }
+    return Result<Acc, E>(ok_tag, std::move(init));
+}
+template <typename Range, typename Acc, typename F>
+auto try_fold(Range&& range, Acc init, F&& fn) {
+    return try_fold(details::range_begin(std::forward<Range>(range)),
+            details::range_end(std::forward<Range>(range)), std::move(init),
+            std::forward<F>(fn));
+}
+
+} // namespace result
+
+#endif
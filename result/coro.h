@@ -0,0 +1,215 @@
+#ifndef RESULT_CORO_H_3f7a9c12_6d4e_4b8a_a5c1_e29f08b7d463
+#define RESULT_CORO_H_3f7a9c12_6d4e_4b8a_a5c1_e29f08b7d463
+
+// C++20 coroutine support: a function returning `Result<T, E>` may use
+// `co_await` on another `Result` to unwrap its value or, on an error, return
+// that error at once, and `co_return` to produce its value.
+//
+//     Result<Config, ConfigError> load(const char* path) {
+//         std::string text = co_await read_file(path);
+//         co_return parse_config(text);
+//     }
+//
+// Opt in by including this header; it requires C++20 and <coroutine>.
+//
+// The coroutine's `Result` is produced by converting the object returned by
+// `get_return_object()`, and it is only complete once the body has run. This
+// relies on the compiler deferring that conversion until the coroutine first
+// returns to its caller, as GCC and Clang do. MSVC converts it eagerly, before
+// the body runs, and is rejected below; on any other compiler that converts
+// eagerly, the conversion panics rather than reading an empty result.
+//
+// The coroutine never suspends except to stop on an error, and its handle
+// never leaves the promise, so compilers that implement heap allocation
+// elision (Clang) can place the frame on the caller's stack. GCC does not
+// elide coroutine frames; there they come from `details::FrameCache`.
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "result/result.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#error "result/coro.h needs deferred return object conversion; see above"
+#endif
+
+namespace result {
+namespace details {
+
+template <typename T, typename E>
+class ResultPromise;
+
+// Where frames are not elided, a chain of `co_await`s allocates and frees a
+// frame per call. Freed frames are kept on a per-thread list by size class
+// and handed out again, which takes the general-purpose allocator off that
+// path. Each list is capped so that a burst of deep recursion does not pin
+// memory for the life of the thread.
+class FrameCache {
+public:
+    static constexpr std::size_t granule = 64;
+    static constexpr std::size_t classes = 16;
+    static constexpr std::size_t max_free = 64;
+
+    FrameCache() = default;
+    FrameCache(const FrameCache&) = delete;
+    FrameCache& operator=(const FrameCache&) = delete;
+    ~FrameCache() {
+        for(Node* head : m_free) {
+            while(head != nullptr) {
+                Node* next = head->next;
+                ::operator delete(head);
+                head = next;
+            }
+        }
+    }
+
+    void* allocate(std::size_t size) {
+        std::size_t index = (size - 1) / granule;
+        if(index < classes && m_free[index] != nullptr) {
+            Node* node = m_free[index];
+            m_free[index] = node->next;
+            --m_count[index];
+            return node;
+        }
+        return ::operator new(index < classes ? (index + 1) * granule : size);
+    }
+    void deallocate(void* frame, std::size_t size) noexcept {
+        std::size_t index = (size - 1) / granule;
+        if(index < classes && m_count[index] < max_free) {
+            m_free[index] = new(frame) Node{m_free[index]};
+            ++m_count[index];
+        } else {
+            ::operator delete(frame);
+        }
+    }
+
+private:
+    struct Node {
+        Node* next;
+    };
+
+    Node* m_free[classes] = {};
+    std::size_t m_count[classes] = {};
+};
+
+inline thread_local FrameCache frame_cache;
+
+// What `get_return_object()` returns. The `Result` is built here rather than
+// in the promise, because the frame, and with it the promise, is destroyed
+// before the caller converts this object to the `Result` it returns.
+template <typename T, typename E>
+class ResultReturnObject {
+public:
+    explicit ResultReturnObject(ResultPromise<T, E>& promise) noexcept
+        : m_promise(&promise) {
+        promise.m_slot = &m_slot;
+    }
+    // Only reachable before the body runs, while the promise is alive.
+    ResultReturnObject(ResultReturnObject&& other) noexcept
+        : ResultReturnObject(*other.m_promise) {}
+    ResultReturnObject(const ResultReturnObject&) = delete;
+    ResultReturnObject& operator=(const ResultReturnObject&) = delete;
+
+    operator Result<T, E>() && {
+        if(!m_slot) {
+            details::panic("result/coro.h: the compiler converted the "
+                           "coroutine return object before the body ran",
+                    __FILE__, __LINE__, __func__);
+        }
+        return std::move(*m_slot);
+    }
+
+private:
+    ResultPromise<T, E>* m_promise;
+    std::optional<Result<T, E>> m_slot;
+};
+
+template <typename U, typename F, typename T, typename E>
+class ResultAwaiter {
+public:
+    explicit ResultAwaiter(Result<U, F>&& result) noexcept
+        : m_result(std::move(result)) {}
+
+    bool await_ready() const noexcept {
+        return hint_ok<F>(m_result.is_ok());
+    }
+    // Stores the error as the coroutine's result and ends the coroutine;
+    // control goes back to the caller, which returns that result.
+    void await_suspend(
+            std::coroutine_handle<ResultPromise<T, E>> handle) noexcept {
+        handle.promise().m_slot->emplace(
+                err_tag, convert_err<E>(std::move(m_result).err_unchecked()));
+        handle.destroy();
+    }
+    U await_resume() { return std::move(m_result).ok_unchecked(); }
+
+private:
+    Result<U, F>&& m_result;
+};
+
+template <typename T, typename E>
+class ResultPromise {
+public:
+    static void* operator new(std::size_t size) {
+        return frame_cache.allocate(size);
+    }
+    static void operator delete(void* frame, std::size_t size) noexcept {
+        frame_cache.deallocate(frame, size);
+    }
+
+    ResultReturnObject<T, E> get_return_object() noexcept {
+        return ResultReturnObject<T, E>(*this);
+    }
+
+    std::suspend_never initial_suspend() const noexcept { return {}; }
+    std::suspend_never final_suspend() const noexcept { return {}; }
+
+    // `co_return` takes an `Ok`, an `Err`, a `Result`, or a plain value that
+    // converts to `T`.
+    template <typename U>
+    void return_value(U&& value) {
+        if constexpr(std::is_convertible<U&&, Result<T, E>>::value) {
+            m_slot->emplace(std::forward<U>(value));
+        } else {
+            static_assert(std::is_convertible<U&&, T>::value,
+                    "co_return needs an Ok, an Err, a Result or a value "
+                    "convertible to T");
+            m_slot->emplace(ok_tag, std::forward<U>(value));
+        }
+    }
+
+    void unhandled_exception() { throw; }
+
+    template <typename U, typename F>
+    ResultAwaiter<U, F, T, E> await_transform(Result<U, F>&& result) noexcept {
+        static_assert(error_converts<F, E>,
+                "co_await on a Result whose error type does not convert to "
+                "the error type of the coroutine; see convert_error");
+        return ResultAwaiter<U, F, T, E>(std::move(result));
+    }
+    template <typename U, typename F>
+    ResultAwaiter<U, F, T, E> await_transform(Result<U, F>& result) = delete;
+
+private:
+    template <typename, typename>
+    friend class ResultReturnObject;
+    template <typename, typename, typename, typename>
+    friend class ResultAwaiter;
+
+    std::optional<Result<T, E>>* m_slot = nullptr;
+};
+
+} // namespace details
+} // namespace result
+
+template <typename T, typename E, typename... Args>
+struct std::coroutine_traits<result::Result<T, E>, Args...> {
+    using promise_type = result::details::ResultPromise<T, E>;
+};
+
+#endif
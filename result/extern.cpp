@@ -0,0 +1,9 @@
+#include "result/extern.h"
+
+namespace result {
+
+#define RESULT_EXTERN_DEFINE_(T, E) template class Result<T, E>;
+RESULT_EXTERN_TYPES(RESULT_EXTERN_DEFINE_)
+#undef RESULT_EXTERN_DEFINE_
+
+} // namespace result
@@ -0,0 +1,37 @@
+#ifndef RESULT_EXTERN_H_6e2d91b4_0f3a_4c87_9d15_b7a48e3c2f60
+#define RESULT_EXTERN_H_6e2d91b4_0f3a_4c87_9d15_b7a48e3c2f60
+
+// Explicit instantiations of `Result` for common payload types, compiled once
+// into the `result_extern` library. Linking against that target defines
+// `RESULT_EXTERN_TEMPLATES`, which makes `result/result.h` include this
+// header, so the member functions of these types are not instantiated and
+// compiled again in every translation unit. Member templates, such as the
+// combinators, still are.
+//
+// Unoptimized builds gain the most. With optimization, compilers still
+// instantiate the inline members to inline them.
+
+#include <cstdint>
+#include <string>
+#include <system_error>
+
+#include "result/result.h"
+
+// X-macro over the instantiated types; `X` receives the two type arguments.
+#define RESULT_EXTERN_TYPES(X)                                                 \
+    X(unit_t, int)                                                             \
+    X(unit_t, std::error_code)                                                 \
+    X(int, std::string)                                                        \
+    X(std::int64_t, std::error_code)                                           \
+    X(std::string, std::string)                                                \
+    X(std::string, std::error_code)
+
+namespace result {
+
+#define RESULT_EXTERN_DECLARE_(T, E) extern template class Result<T, E>;
+RESULT_EXTERN_TYPES(RESULT_EXTERN_DECLARE_)
+#undef RESULT_EXTERN_DECLARE_
+
+} // namespace result
+
+#endif
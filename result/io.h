@@ -0,0 +1,73 @@
+#ifndef RESULT_IO_H_8b3e6f41_2c7d_4a59_b1e0_5d94c3a7f218
+#define RESULT_IO_H_8b3e6f41_2c7d_4a59_b1e0_5d94c3a7f218
+
+// Stream output for `Result`, `Ok`, `Err` and `unit_t`.
+//
+// Kept apart from result.h so that code which never prints a `Result` does
+// not pay for including <ostream>.
+
+#include <functional>
+#include <ostream>
+#include <type_traits>
+
+#include "result/result.h"
+
+namespace result {
+
+template <typename T>
+inline std::ostream& operator<<(
+        std::ostream& stream, const std::reference_wrapper<T>& obj);
+
+inline std::ostream& operator<<(std::ostream& stream, unit_t) {
+    stream << "()";
+    return stream;
+}
+
+template <typename T>
+inline std::ostream& operator<<(std::ostream& stream, const Ok<T>& ok) {
+    if constexpr(std::is_same<T, unit_t>::value) {
+        stream << "Ok()";
+    } else {
+        stream << "Ok(" << ok.value() << ")";
+    }
+    return stream;
+}
+template <typename T>
+inline std::ostream& operator<<(std::ostream& stream, const Err<T>& err) {
+    stream << "Err(" << err.value() << ")";
+    return stream;
+}
+
+template <typename T, typename E>
+inline std::ostream& operator<<(
+        std::ostream& stream, const Result<T, E>& result) {
+    switch(result.kind()) {
+    case ResultKind::Ok: {
+        if constexpr(std::is_same<T, unit_t>::value) {
+            stream << "Ok()";
+        } else {
+            stream << "Ok(" << result.ok().value() << ")";
+        }
+        break;
+    }
+    case ResultKind::Err: {
+        stream << "Err(" << result.err().value() << ")";
+        break;
+    }
+    default:
+        stream << "INVALID RESULT";
+        break;
+    }
+    return stream;
+}
+
+template <typename T>
+inline std::ostream& operator<<(
+        std::ostream& stream, const std::reference_wrapper<T>& obj) {
+    stream << obj.get();
+    return stream;
+}
+
+} // namespace result
+
+#endif
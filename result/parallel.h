@@ -0,0 +1,550 @@
+#ifndef RESULT_PARALLEL_H_e7f14a3b_26c9_4d80_9b5e_3a18d6c2f047
+#define RESULT_PARALLEL_H_e7f14a3b_26c9_4d80_9b5e_3a18d6c2f047
+
+// Parallel maps over ranges with fallible functions:
+//
+// - `par_map(range, fn)` calls `fn`, which returns a `Result`, on every
+//   element of a random access range.
+// - `par_and_then(range, fn)` does the same for the `Ok` values of a range of
+//   `Result`s, passing its errors through.
+// - `par_try_for_each(range, fn)` and `try_reduce(range, identity, op)` run
+//   `fn` for its effects and reduce a range, and return the first error to
+//   occur, cancelling the rest of the call; see `CancellationToken`.
+//
+// By default (`stop_on_first`) the call returns `Result<std::vector<U>, E>`,
+// and no further chunks of the range are started once an element fails. The
+// error returned is the one of the lowest index, as in a sequential loop.
+// With `collect_all` every element is processed and the call returns a
+// `std::vector<Result<U, E>>`. Results are written into a vector sized up
+// front, so `U` must be default constructible.
+//
+// The work runs on a `ThreadPool`, `ThreadPool::shared()` unless another is
+// given, and on the calling thread, which takes part in every call. Calls may
+// be nested. An exception thrown by `fn` cancels the call and is rethrown from
+// it.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "result/collect.h"
+#include "result/result.h"
+
+namespace result {
+
+/// A fixed set of worker threads running submitted tasks in order.
+class ThreadPool {
+public:
+    /// Starts `threads` workers. The default leaves one hardware thread for
+    /// the caller of `par_map`, which works alongside the pool.
+    explicit ThreadPool(std::size_t threads = default_size()) {
+        m_threads.reserve(threads);
+        for(std::size_t i = 0; i < threads; ++i) {
+            m_threads.emplace_back([this] { work(); });
+        }
+    }
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    /// Runs the tasks already submitted, then joins the workers.
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for(std::thread& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    std::size_t size() const noexcept { return m_threads.size(); }
+
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+        }
+        m_wake.notify_one();
+    }
+
+    /// The pool used when none is given, started on first use.
+    static ThreadPool& shared() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    static std::size_t default_size() noexcept {
+        unsigned hardware = std::thread::hardware_concurrency();
+        return hardware > 1 ? hardware - 1 : 0;
+    }
+
+private:
+    void work() {
+        for(;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock,
+                        [this] { return m_stopping || !m_tasks.empty(); });
+                if(m_tasks.empty()) {
+                    return;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<std::function<void()>> m_tasks;
+    bool m_stopping = false;
+    std::vector<std::thread> m_threads;
+};
+
+/// Selects the error handling of `par_map` and `par_and_then`: stop at the
+/// first error and return it.
+struct stop_on_first_t {};
+/// Selects the error handling of `par_map` and `par_and_then`: process every
+/// element and return every result.
+struct collect_all_t {};
+inline constexpr stop_on_first_t stop_on_first{};
+inline constexpr collect_all_t collect_all{};
+
+/// Set once a call of `par_try_for_each` or `try_reduce` has failed. A
+/// function run by those calls that takes a `const CancellationToken&` as its
+/// last parameter gets the call's token, and may poll it to give up early on
+/// long work; whatever it returns after that is ignored.
+class CancellationToken {
+public:
+    bool is_cancelled() const noexcept {
+        return m_cancelled.load(std::memory_order_relaxed);
+    }
+    void cancel() noexcept {
+        m_cancelled.store(true, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<bool> m_cancelled{false};
+};
+
+struct ParallelOptions {
+    /// The pool to run on; `ThreadPool::shared()` if null.
+    ThreadPool* pool = nullptr;
+    /// Elements per chunk; picked from the size of the range and the pool if
+    /// zero. Smaller chunks balance better and stop sooner after an error.
+    std::size_t chunk_size = 0;
+};
+
+namespace details {
+
+// The state of one parallel call, shared with the tasks submitted for it.
+// Those tasks may start after the call has returned; `m_closed` tells them
+// not to touch the body, which lives on the caller's stack.
+template <typename Body>
+class ParallelRun {
+public:
+    ParallelRun(Body& body, std::size_t count, std::size_t chunk)
+        : m_body(&body), m_count(count), m_chunk(chunk), m_first_err(count) {}
+
+    // Runs chunks until none are left. Called by the caller and the helpers.
+    void help() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if(m_closed) {
+                return;
+            }
+            ++m_active;
+        }
+        run_chunks();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_active;
+        }
+        m_done.notify_all();
+    }
+
+    // Waits for the helpers that started, and keeps the others out.
+    void close() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_closed = true;
+        m_done.wait(lock, [this] { return m_active == 0; });
+        if(m_exception) {
+            std::rethrow_exception(m_exception);
+        }
+    }
+
+    const CancellationToken& token() const noexcept { return m_token; }
+    // Stops the whole call: no chunk is started after this, and functions
+    // that poll the token give up.
+    void cancel() noexcept {
+        fail(0);
+        m_token.cancel();
+    }
+
+    // True if an element before `index` has failed.
+    bool cancelled_before(std::size_t index) const noexcept {
+        return m_first_err.load(std::memory_order_relaxed) < index;
+    }
+    // Records a failure at `index`; returns true if it is the earliest yet.
+    bool fail(std::size_t index) noexcept {
+        std::size_t first = m_first_err.load(std::memory_order_relaxed);
+        while(index < first) {
+            if(m_first_err.compare_exchange_weak(
+                       first, index, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    void run_chunks() {
+        for(;;) {
+            std::size_t begin =
+                    m_next.fetch_add(m_chunk, std::memory_order_relaxed);
+            if(begin >= m_count || cancelled_before(begin) ||
+                    m_token.is_cancelled()) {
+                return;
+            }
+            try {
+                (*m_body)(*this, begin, std::min(begin + m_chunk, m_count));
+            } catch(...) {
+                cancel();
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if(!m_exception) {
+                    m_exception = std::current_exception();
+                }
+            }
+        }
+    }
+
+    Body* m_body;
+    const std::size_t m_count;
+    const std::size_t m_chunk;
+    std::atomic<std::size_t> m_next{0};
+    std::atomic<std::size_t> m_first_err;
+    CancellationToken m_token;
+
+    std::mutex m_mutex;
+    std::condition_variable m_done;
+    std::size_t m_active = 0;
+    bool m_closed = false;
+    std::exception_ptr m_exception;
+};
+
+inline ThreadPool& pool_of(const ParallelOptions& options) {
+    return options.pool ? *options.pool : ThreadPool::shared();
+}
+
+inline std::size_t chunk_size_for(
+        std::size_t count, const ParallelOptions& options) {
+    if(options.chunk_size != 0) {
+        return options.chunk_size;
+    }
+    std::size_t threads = pool_of(options).size() + 1;
+    return std::max<std::size_t>(1, count / (threads * 8));
+}
+
+// Calls `body(run, begin, end)` over chunks of [0, count) on the pool and the
+// calling thread.
+template <typename Body>
+void parallel_chunks(
+        std::size_t count, const ParallelOptions& options, Body& body) {
+    if(count == 0) {
+        return;
+    }
+    ThreadPool& pool = pool_of(options);
+    std::size_t chunk = chunk_size_for(count, options);
+    std::size_t chunks = (count + chunk - 1) / chunk;
+    auto run = std::make_shared<ParallelRun<Body>>(body, count, chunk);
+    for(std::size_t i = 1; i < std::min(chunks, pool.size() + 1); ++i) {
+        pool.submit([run] { run->help(); });
+    }
+    run->help();
+    run->close();
+}
+
+template <typename It, typename F>
+using par_map_result = std::invoke_result_t<F&,
+        typename std::iterator_traits<It>::reference>;
+
+template <typename It, typename F>
+auto par_map(It first, std::size_t count, F& fn, stop_on_first_t,
+        const ParallelOptions& options) {
+    using R = par_map_result<It, F>;
+    using U = typename R::value_type;
+    using E = typename R::error_type;
+    static_assert(std::is_default_constructible<U>::value,
+            "par_map writes into a preallocated vector, so the value type "
+            "must be default constructible");
+    static_assert(!std::is_same<U, bool>::value,
+            "par_map cannot write std::vector<bool> from several threads; "
+            "return a Result of char or unit_t instead");
+
+    std::vector<U> values(count);
+    std::optional<E> error;
+    std::mutex error_mutex;
+    auto body = [&](auto& run, std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end && !run.cancelled_before(i); ++i) {
+            R result = std::invoke(fn, first[i]);
+            if(hint_ok<E>(result.is_ok())) {
+                values[i] = std::move(result).ok_unchecked();
+            } else {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if(run.fail(i)) {
+                    error.emplace(std::move(result).err_unchecked());
+                }
+                return;
+            }
+        }
+    };
+    parallel_chunks(count, options, body);
+    if(error) {
+        return Result<std::vector<U>, E>(err_tag, std::move(*error));
+    }
+    return Result<std::vector<U>, E>(ok_tag, std::move(values));
+}
+
+template <typename It, typename F>
+auto par_map(It first, std::size_t count, F& fn, collect_all_t,
+        const ParallelOptions& options) {
+    using R = par_map_result<It, F>;
+    static_assert(std::is_default_constructible<R>::value,
+            "par_map writes into a preallocated vector, so the value type "
+            "must be default constructible");
+
+    std::vector<R> results(count);
+    auto body = [&](auto&, std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; ++i) {
+            results[i] = std::invoke(fn, first[i]);
+        }
+    };
+    parallel_chunks(count, options, body);
+    return results;
+}
+
+// Calls `fn(args..., token)` if `fn` takes the token, else `fn(args...)`.
+template <typename F, typename... Args>
+decltype(auto) invoke_cancellable(
+        F& fn, const CancellationToken& token, Args&&... args) {
+    if constexpr(std::is_invocable<F&, Args&&...,
+                         const CancellationToken&>::value) {
+        return std::invoke(fn, std::forward<Args>(args)..., token);
+    } else {
+        return std::invoke(fn, std::forward<Args>(args)...);
+    }
+}
+
+// The first error to occur, in time, among the workers of a call; recording
+// it cancels the call.
+template <typename E>
+class FirstError {
+public:
+    template <typename Run>
+    void record(Run& run, E&& error) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if(!m_error) {
+                m_error.emplace(std::move(error));
+            }
+        }
+        run.cancel();
+    }
+
+    explicit operator bool() const noexcept { return m_error.has_value(); }
+    E take() { return std::move(*m_error); }
+
+private:
+    std::mutex m_mutex;
+    std::optional<E> m_error;
+};
+
+template <typename It>
+std::size_t random_access_count(const It& first, const It& last) {
+    static_assert(std::is_base_of<std::random_access_iterator_tag,
+                          typename std::iterator_traits<
+                                  It>::iterator_category>::value,
+            "parallel algorithms need a random access range");
+    return static_cast<std::size_t>(last - first);
+}
+
+} // namespace details
+
+/// Calls `fn` on every element of `range` in parallel; see the top of this
+/// file.
+///
+///     Result<std::vector<Record>, ParseError> records =
+///             par_map(lines, parse_record);
+template <typename Range, typename F, typename Policy = stop_on_first_t>
+auto par_map(Range&& range,
+        F&& fn,
+        Policy policy = {},
+        const ParallelOptions& options = {}) {
+    auto first = details::range_begin(std::forward<Range>(range));
+    auto last = details::range_end(std::forward<Range>(range));
+    return details::par_map(first, details::random_access_count(first, last),
+            fn, policy, options);
+}
+
+/// Calls `fn` on the `Ok` values of a range of `Result<T, E>` in parallel.
+/// `fn` returns a `Result<U, F>` whose error converts to `E`; the errors of
+/// the range are passed through as if `fn` had returned them.
+///
+///     Result<std::vector<Record>, ParseError> checked =
+///             par_and_then(std::move(records), validate);
+template <typename Range, typename F, typename Policy = stop_on_first_t>
+auto par_and_then(Range&& range,
+        F&& fn,
+        Policy policy = {},
+        const ParallelOptions& options = {}) {
+    using Input = details::element_result<decltype(
+            details::range_begin(std::forward<Range>(range)))>;
+    using E = typename Input::error_type;
+    auto step = [&fn](auto&& result) {
+        using U = typename std::invoke_result_t<F&,
+                decltype(std::forward<decltype(result)>(result)
+                                 .ok_unchecked())>::value_type;
+        if(details::hint_ok<E>(result.is_ok())) {
+            return Result<U, E>(std::invoke(fn,
+                    std::forward<decltype(result)>(result).ok_unchecked()));
+        }
+        return Result<U, E>(err_tag,
+                std::forward<decltype(result)>(result).err_unchecked());
+    };
+    return par_map(std::forward<Range>(range), step, policy, options);
+}
+
+/// Calls `fn`, which returns a `Result`, on every element of `range` in
+/// parallel, and returns `Status<E>`: `Ok` if every call succeeded, else the
+/// first error to occur in time, which need not be the one of the lowest
+/// index. The error cancels the call's `CancellationToken`: no chunk is
+/// started after it, and calls of `fn` that take the token may stop early.
+///
+///     Status<IoError> written = par_try_for_each(pages,
+///             [&](const Page& page, const CancellationToken& token) {
+///                 return write_page(page, token);
+///             });
+template <typename Range, typename F>
+auto par_try_for_each(
+        Range&& range, F&& fn, const ParallelOptions& options = {}) {
+    auto first = details::range_begin(std::forward<Range>(range));
+    auto last = details::range_end(std::forward<Range>(range));
+    std::size_t count = details::random_access_count(first, last);
+    using R = std::decay_t<decltype(details::invoke_cancellable(fn,
+            std::declval<const CancellationToken&>(), first[0]))>;
+    using E = typename R::error_type;
+
+    details::FirstError<E> error;
+    auto body = [&](auto& run, std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end && !run.token().is_cancelled();
+                ++i) {
+            R result = details::invoke_cancellable(fn, run.token(), first[i]);
+            if(details::hint_err<E>(result.is_err())) {
+                error.record(run, std::move(result).err_unchecked());
+                return;
+            }
+        }
+    };
+    details::parallel_chunks(count, options, body);
+    if(error) {
+        return Status<E>(err_tag, error.take());
+    }
+    return Status<E>(ok_tag);
+}
+
+/// Reduces `range` in parallel with `op(T, T) -> Result<T, E>`, which must be
+/// associative with `identity` as its identity. Each chunk is folded from
+/// `identity` with `op(acc, element)`, then the partial results are combined
+/// pairwise, as a tree, level by level. Errors are handled as in
+/// `par_try_for_each`, and `op` may take the call's `CancellationToken` as a
+/// third parameter.
+///
+///     Result<Money, Overflow> total = try_reduce(amounts, Money(0),
+///             [](Money a, Money b) { return checked_add(a, b); });
+template <typename Range, typename T, typename Op>
+auto try_reduce(Range&& range,
+        T identity,
+        Op&& op,
+        const ParallelOptions& options = {}) {
+    auto first = details::range_begin(std::forward<Range>(range));
+    auto last = details::range_end(std::forward<Range>(range));
+    std::size_t count = details::random_access_count(first, last);
+    using R = std::decay_t<decltype(details::invoke_cancellable(op,
+            std::declval<const CancellationToken&>(), std::declval<T>(),
+            std::declval<T>()))>;
+    using E = typename R::error_type;
+    static_assert(std::is_same<typename R::value_type, T>::value,
+            "try_reduce needs an op returning Result<T, E>");
+
+    ParallelOptions leaves = options;
+    leaves.chunk_size = details::chunk_size_for(count, options);
+    std::vector<std::optional<T>> partials(
+            (count + leaves.chunk_size - 1) / leaves.chunk_size);
+    details::FirstError<E> error;
+    auto fold = [&](auto& run, std::size_t begin, std::size_t end) {
+        T acc = identity;
+        for(std::size_t i = begin; i < end; ++i) {
+            if(run.token().is_cancelled()) {
+                return;
+            }
+            R result = details::invoke_cancellable(
+                    op, run.token(), std::move(acc), first[i]);
+            if(details::hint_err<E>(result.is_err())) {
+                error.record(run, std::move(result).err_unchecked());
+                return;
+            }
+            acc = std::move(result).ok_unchecked();
+        }
+        partials[begin / leaves.chunk_size].emplace(std::move(acc));
+    };
+    details::parallel_chunks(count, leaves, fold);
+
+    // Level `stride` combines partials[i] with partials[i + stride] into
+    // partials[i], for every i that is a multiple of 2 * stride.
+    ParallelOptions pairs = options;
+    pairs.chunk_size = 1;
+    for(std::size_t stride = 1; stride < partials.size() && !error;
+            stride *= 2) {
+        auto combine = [&](auto& run, std::size_t begin, std::size_t end) {
+            for(std::size_t pair = begin; pair < end; ++pair) {
+                std::size_t i = pair * 2 * stride;
+                R result = details::invoke_cancellable(op, run.token(),
+                        std::move(*partials[i]),
+                        std::move(*partials[i + stride]));
+                if(details::hint_err<E>(result.is_err())) {
+                    error.record(run, std::move(result).err_unchecked());
+                    return;
+                }
+                partials[i].emplace(std::move(result).ok_unchecked());
+            }
+        };
+        std::size_t count_pairs =
+                (partials.size() - stride + 2 * stride - 1) / (2 * stride);
+        details::parallel_chunks(count_pairs, pairs, combine);
+    }
+    if(error) {
+        return Result<T, E>(err_tag, error.take());
+    }
+    if(partials.empty()) {
+        return Result<T, E>(ok_tag, std::move(identity));
+    }
+    return Result<T, E>(ok_tag, std::move(*partials[0]));
+}
+
+} // namespace result
+
+#endif
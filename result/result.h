@@ -1,12 +1,18 @@
 #ifndef RESULT_H_1de851ad_b9f8_434d_b73d_f06a6b5daa9a
 #define RESULT_H_1de851ad_b9f8_434d_b73d_f06a6b5daa9a
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
 #include <functional>
-#include <iostream>
+#include <memory>
 #include <optional>
-#include <string>
 #include <string_view>
+#include <system_error>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
@@ -17,11 +23,6 @@ using optional = std::optional<T>;
 using nullopt_t = std::nullopt_t;
 inline constexpr nullopt_t nullopt = std::nullopt;
 
-
-template <typename T>
-inline std::ostream& operator<<(
-        std::ostream& stream, const std::reference_wrapper<T>& obj);
-
 enum class ResultKind : uint8_t {
     Ok = 0,
     Err = 1,
@@ -30,6 +31,9 @@ enum class ResultKind : uint8_t {
 template <typename T, typename E>
 class[[nodiscard]] Result;
 
+template <typename T0, typename E0, typename T, typename E, typename... Stages>
+class LazyResult;
+
 struct ok_tag_t {};
 struct err_tag_t {};
 struct unit_t {};
@@ -44,6 +48,14 @@ struct is_result : std::false_type {};
 template <typename T, typename E>
 struct is_result<Result<T, E>> : std::true_type {};
 
+/// A `Result` that only reports success or failure.
+///
+/// If `E` has a niche, such as `std::error_code` whose zero value means
+/// success, the `Ok` state is stored as that niche: a `Status<E>` is exactly
+/// `sizeof(E)` and `is_ok()` is a single comparison.
+template <typename E>
+using Status = Result<unit_t, E>;
+
 inline constexpr bool operator==(unit_t, unit_t) { return true; }
 inline constexpr bool operator!=(unit_t, unit_t) { return false; }
 
@@ -73,15 +85,6 @@ public:
     constexpr const T& value() const& { return m_value; }
     constexpr T&& value() && { return std::move(m_value); }
 
-    template <typename E>
-    constexpr operator Result<T, E>() const& {
-        return Result<T, E>(Ok(m_value));
-    }
-    template <typename E>
-    constexpr operator Result<T, E>() && {
-        return Result<T, E>(Ok(std::move(m_value)));
-    }
-
 private:
     T m_value;
 };
@@ -99,137 +102,805 @@ public:
 
 Ok()->Ok<unit_t>;
 
+/// Customization point describing a value of `T` that is never a valid value.
+///
+/// When one alternative of a `Result` has a niche and the other alternative is
+/// an empty type such as `unit_t`, the `Result` stores the empty alternative
+/// as the niche value instead of keeping a separate tag, so
+/// `sizeof(Result<T, unit_t>) == sizeof(T)`.
+///
+/// Specializations must provide `has_niche = true`, `niche_value()` returning
+/// the reserved value and `is_niche(const T&)`. Storing the niche value as a
+/// real `Ok` or `Err` is undefined. A specialization whose niche value is a
+/// legitimate value, only never an error, sets `err_only = true`; the niche is
+/// then used only where `T` is the error type.
+template <typename T, typename = void>
+struct niche_traits {
+    static constexpr bool has_niche = false;
+};
+
+/// Helper for `niche_traits` specializations that reserve a single sentinel,
+/// such as a spare enumerator:
+///
+///     template <>
+///     struct niche_traits<Color> : sentinel_niche<Color, Color::Count> {};
+template <typename T, T Sentinel>
+struct sentinel_niche {
+    static constexpr bool has_niche = true;
+
+    static constexpr T niche_value() noexcept { return Sentinel; }
+    static constexpr bool is_niche(const T& value) noexcept {
+        return value == Sentinel;
+    }
+};
+
+/// A `std::error_code` with a value of zero represents success rather than an
+/// error, so it is reserved as the niche of `Status<std::error_code>`. As a
+/// value it is perfectly valid, so the niche is not used for `Ok`s.
+template <>
+struct niche_traits<std::error_code> {
+    static constexpr bool has_niche = true;
+    static constexpr bool err_only = true;
+
+    static std::error_code niche_value() noexcept { return std::error_code(); }
+    static bool is_niche(const std::error_code& value) noexcept {
+        return value.value() == 0;
+    }
+};
+
+/// Data pointers reserve the all-ones address. It is misaligned for any type
+/// with an alignment above one and is never mapped in user space otherwise.
+template <typename T>
+struct niche_traits<T*, std::enable_if_t<!std::is_function<T>::value>> {
+    static constexpr bool has_niche = true;
+
+    static T* niche_value() noexcept {
+        return reinterpret_cast<T*>(~std::uintptr_t(0));
+    }
+    static bool is_niche(T* value) noexcept { return value == niche_value(); }
+};
+
+/// Branch prediction policy for results with error type `E`.
+///
+/// By default the combinators and `unwrap_or*` tell the compiler that `Ok` is
+/// the common case, so the error handling is laid out off the hot path. For
+/// error types that are routine rather than exceptional, such as "not found"
+/// from a lookup, specialize this to `std::false_type` to drop the hints:
+///
+///     template <>
+///     struct ok_is_likely<LookupError> : std::false_type {};
+template <typename E>
+struct ok_is_likely : std::true_type {};
+
+/// Converts an error of type `From` into one of type `To` where a `Result`
+/// crosses from one layer into another: in the converting constructor of
+/// `Result`, in `and_then` when the continuation returns a different error
+/// type, and in `RESULT_TRY` and `co_await`. The converted error is built
+/// directly in the destination `Result`.
+///
+/// By default an error converts when `From` is implicitly convertible to
+/// `To`. Specialize this to map between unrelated error types without a
+/// `map_err` at every boundary:
+///
+///     template <>
+///     struct convert_error<IoError, ServiceError> {
+///         static ServiceError convert(IoError&& error) {
+///             return ServiceError{ServiceError::Io, error.code};
+///         }
+///     };
+template <typename From, typename To>
+struct convert_error {
+    template <typename F = From,
+            std::enable_if_t<std::is_convertible<F&&, To>::value, int> = 0>
+    static constexpr To convert(From&& error) {
+        return std::move(error);
+    }
+};
+
+/// The place in the caller's source that made a failing call to `unwrap`,
+/// `expect` or `try_ok`. A stand-in for C++20's `std::source_location`.
+struct source_location {
+    const char* file = "unknown";
+    unsigned line = 0;
+    const char* function = "unknown";
+
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+    static constexpr source_location current(
+            const char* file = __builtin_FILE(),
+            unsigned line = __builtin_LINE(),
+            const char* function = __builtin_FUNCTION()) noexcept {
+        return source_location{file, line, function};
+    }
+#else
+    static constexpr source_location current() noexcept {
+        return source_location{};
+    }
+#endif
+};
+
+/// Called when `unwrap`, `expect`, `try_ok` or one of their `_err` variants
+/// is used on the wrong kind of `Result`.
+///
+/// The handler must not return: it may throw, longjmp or end the process. If
+/// it returns anyway, `std::terminate()` is called.
+using panic_handler = void (*)(
+        std::string_view message, const source_location& location);
+
+namespace details {
+
+// Writes "file:line: function: message" to stderr without allocating.
+inline void default_panic_handler(
+        std::string_view message, const source_location& location) {
+    std::fprintf(stderr,
+            "%s:%u: %s: %.*s\n",
+            location.file,
+            location.line,
+            location.function,
+            static_cast<int>(message.size()),
+            message.data());
+}
+
+// Constant-initialized, so including the header adds no static constructor.
+inline std::atomic<panic_handler> current_panic_handler{
+        &default_panic_handler};
+
+} // namespace details
+
+/// Installs `handler` for every thread and returns the previous one. Passing
+/// `nullptr` restores the default handler, which prints the message and the
+/// location to stderr.
+inline panic_handler set_panic_handler(panic_handler handler) noexcept {
+    if(handler == nullptr) {
+        handler = &details::default_panic_handler;
+    }
+    return details::current_panic_handler.exchange(handler);
+}
+inline panic_handler get_panic_handler() noexcept {
+    return details::current_panic_handler.load();
+}
 
 namespace details {
 
-inline void terminate(const std::string_view& msg) {
-    std::cerr << msg << std::endl;
+// Kept out of line and marked cold so that the call to the handler is not
+// inlined into every `unwrap` and `expect`, and the branch that reaches it is
+// treated as unlikely. The location is passed field by field so that it
+// travels in registers and is only set up once the branch is taken.
+[[noreturn]]
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((cold, noinline))
+#elif defined(_MSC_VER)
+__declspec(noinline)
+#endif
+inline void panic(std::string_view message,
+        const char* file,
+        unsigned line,
+        const char* function) {
+    get_panic_handler()(message, source_location{file, line, function});
     std::terminate();
 }
 
+// `ok`, with a hint that it is true unless `ok_is_likely<E>` opts out.
+template <typename E>
+constexpr bool hint_ok(bool ok) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    if constexpr(ok_is_likely<E>::value) {
+        return __builtin_expect(ok, true);
+    }
+#endif
+    return ok;
+}
+// `err`, with a hint that it is false unless `ok_is_likely<E>` opts out.
+template <typename E>
+constexpr bool hint_err(bool err) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    if constexpr(ok_is_likely<E>::value) {
+        return __builtin_expect(err, false);
+    }
+#endif
+    return err;
+}
+
+// Tells the optimizer that `condition` holds. If it does not, the behavior
+// is undefined. In a constant expression a false condition is an error.
+constexpr void assume(bool condition) noexcept {
+    if(!condition) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_unreachable();
+#elif defined(_MSC_VER)
+        __assume(0);
+#endif
+    }
+}
+
+struct no_init_t {};
+
+template <typename From, typename To, typename = void>
+inline constexpr bool error_converts = false;
+template <typename From, typename To>
+inline constexpr bool error_converts<From, To,
+        std::void_t<decltype(convert_error<From, To>::convert(
+                std::declval<From&&>()))>> =
+        std::is_convertible<decltype(convert_error<From, To>::convert(
+                                    std::declval<From&&>())),
+                To>::value;
+
+// An error waiting to be converted to `To` by `convert_error`. Passed as the
+// constructor argument of an error, it is unwrapped by `init_arg`, so the
+// converted error is a prvalue that initializes the storage directly rather
+// than a temporary that is then moved into it.
+template <typename To, typename Ref>
+class ConvertedError {
+    using From = std::remove_cv_t<std::remove_reference_t<Ref>>;
+
+public:
+    explicit constexpr ConvertedError(Ref error) noexcept
+        : m_error(std::forward<Ref>(error)) {}
+
+    constexpr To make() && {
+        if constexpr(std::is_same<From, To>::value) {
+            return std::forward<Ref>(m_error);
+        } else if constexpr(std::is_same<Ref, From&&>::value) {
+            return convert_error<From, To>::convert(std::move(m_error));
+        } else {
+            return convert_error<From, To>::convert(From(m_error));
+        }
+    }
+
+private:
+    Ref m_error;
+};
+
+template <typename To, typename From>
+constexpr ConvertedError<To, From&&> convert_err(From&& error) noexcept {
+    return ConvertedError<To, From&&>(std::forward<From>(error));
+}
+
+template <typename Arg>
+constexpr Arg&& init_arg(Arg&& arg) noexcept {
+    return std::forward<Arg>(arg);
+}
+template <typename To, typename Ref>
+constexpr To init_arg(ConvertedError<To, Ref>&& arg) {
+    return std::move(arg).make();
+}
+
+template <typename T, typename = void>
+struct niche_err_only : std::false_type {};
+template <typename T>
+struct niche_err_only<T, std::void_t<decltype(niche_traits<T>::err_only)>>
+    : std::integral_constant<bool, niche_traits<T>::err_only> {};
+
+// Whether `Value`, the alternative `Kind` of a Result, can hold the other,
+// `Empty`, as its niche.
+template <typename Value, typename Empty, ResultKind Kind>
+inline constexpr bool can_use_niche = niche_traits<Value>::has_niche &&
+        (Kind == ResultKind::Err || !niche_err_only<Value>::value) &&
+        std::is_empty<Empty>::value && std::is_trivial<Empty>::value &&
+        !std::is_final<Empty>::value;
+
+template <typename T, typename E>
+struct tagged_layout {
+    static constexpr std::size_t payload_size =
+            sizeof(T) > sizeof(E) ? sizeof(T) : sizeof(E);
+    static constexpr std::size_t payload_align =
+            alignof(T) > alignof(E) ? alignof(T) : alignof(E);
+    // True if the union of T and E ends in padding that can hold the tag.
+    static constexpr bool tag_in_padding = payload_size % payload_align != 0;
+};
+
+enum class StorageLayout {
+    // The tag follows the union of T and E.
+    TagAfter,
+    // The tag lives in the trailing padding of the union of T and E.
+    TagInPadding,
+    // Only T is stored and an Err is encoded as T's niche value.
+    NicheInOk,
+    // Only E is stored and an Ok is encoded as E's niche value.
+    NicheInErr,
+};
+
+// The layout policy: picks the representation with the smallest sizeof.
+template <typename T, typename E>
+inline constexpr StorageLayout storage_layout =
+        can_use_niche<T, E, ResultKind::Ok>
+        ? StorageLayout::NicheInOk
+        : can_use_niche<E, T, ResultKind::Err>
+                ? StorageLayout::NicheInErr
+                : tagged_layout<T, E>::tag_in_padding
+                        ? StorageLayout::TagInPadding
+                        : StorageLayout::TagAfter;
+
+template <typename T, typename E,
+        bool = std::is_trivially_destructible<T>::value &&
+                std::is_trivially_destructible<E>::value>
+union ResultUnion {
+    constexpr ResultUnion() noexcept : m_none() {}
+    template <typename... Args>
+    constexpr ResultUnion(ok_tag_t, Args&&... args)
+        : m_ok(std::forward<Args>(args)...) {}
+    template <typename... Args>
+    constexpr ResultUnion(err_tag_t, Args&&... args)
+        : m_err(init_arg(std::forward<Args>(args))...) {}
+
+    unsigned char m_none;
+    T m_ok;
+    E m_err;
+};
+
+template <typename T, typename E>
+union ResultUnion<T, E, false> {
+    constexpr ResultUnion() noexcept : m_none() {}
+    template <typename... Args>
+    constexpr ResultUnion(ok_tag_t, Args&&... args)
+        : m_ok(std::forward<Args>(args)...) {}
+    template <typename... Args>
+    constexpr ResultUnion(err_tag_t, Args&&... args)
+        : m_err(init_arg(std::forward<Args>(args))...) {}
+
+    // The active member is destroyed by ResultStorageDestructor.
+    ~ResultUnion() {}
+
+    unsigned char m_none;
+    T m_ok;
+    E m_err;
+};
+
+// A union of T and E followed by the tag. This is the only tagged layout that
+// can be used in constant expressions.
+template <typename T, typename E,
+        bool = storage_layout<T, E> == StorageLayout::TagInPadding>
+class TaggedBuffer {
+public:
+    constexpr TaggedBuffer(no_init_t) noexcept : m_tag(ResultKind::Ok) {}
+    template <typename... Args>
+    constexpr TaggedBuffer(ok_tag_t, Args&&... args)
+        : m_union(ok_tag, std::forward<Args>(args)...), m_tag(ResultKind::Ok) {}
+    template <typename... Args>
+    constexpr TaggedBuffer(err_tag_t, Args&&... args)
+        : m_union(err_tag, std::forward<Args>(args)...),
+          m_tag(ResultKind::Err) {}
+
+    constexpr const T& ok() const noexcept { return m_union.m_ok; }
+    constexpr T& ok() noexcept { return m_union.m_ok; }
+    constexpr const E& err() const noexcept { return m_union.m_err; }
+    constexpr E& err() noexcept { return m_union.m_err; }
+
+    constexpr ResultKind tag() const noexcept { return m_tag; }
+    constexpr void set_tag(ResultKind tag) noexcept { m_tag = tag; }
+
+private:
+    ResultUnion<T, E> m_union;
+    ResultKind m_tag;
+};
+
+// Raw bytes holding T or E with the tag in the padding after the larger of
+// the two. A union cannot express this, so this layout is not usable in
+// constant expressions.
+template <typename T, typename E>
+class TaggedBuffer<T, E, true> {
+    using layout = tagged_layout<T, E>;
+
+public:
+    TaggedBuffer(no_init_t) noexcept {}
+    template <typename... Args>
+    TaggedBuffer(ok_tag_t, Args&&... args) {
+        new(&m_data) std::decay_t<T>(std::forward<Args>(args)...);
+        set_tag(ResultKind::Ok);
+    }
+    template <typename... Args>
+    TaggedBuffer(err_tag_t, Args&&... args) {
+        new(&m_data) std::decay_t<E>(init_arg(std::forward<Args>(args))...);
+        set_tag(ResultKind::Err);
+    }
+
+    const T& ok() const noexcept { return *reinterpret_cast<const T*>(&m_data); }
+    T& ok() noexcept { return *reinterpret_cast<T*>(&m_data); }
+    const E& err() const noexcept {
+        return *reinterpret_cast<const E*>(&m_data);
+    }
+    E& err() noexcept { return *reinterpret_cast<E*>(&m_data); }
+
+    ResultKind tag() const noexcept {
+        return static_cast<ResultKind>(
+                reinterpret_cast<const unsigned char*>(
+                        &m_data)[layout::payload_size]);
+    }
+    void set_tag(ResultKind tag) noexcept {
+        reinterpret_cast<unsigned char*>(&m_data)[layout::payload_size] =
+                static_cast<unsigned char>(tag);
+    }
+
+private:
+    std::aligned_storage_t<layout::payload_size + 1, layout::payload_align>
+            m_data;
+};
+
+// The storage of a Result is built up in layers so that each special member
+// function is trivial whenever it is trivial for both T and E. This keeps
+// Result<int, int> and friends trivially copyable, which lets them be passed
+// and returned in registers.
 template <typename T, typename E>
-class ResultStorage {
+class ResultStorageData {
     using DecayT = std::decay_t<T>;
     using DecayE = std::decay_t<E>;
 
 public:
     using value_type = T;
     using error_type = E;
-    using data_type = std::aligned_union_t<1, T, E>;
-
-    ResultStorage() = delete;
 
     template <typename... Args>
-    constexpr ResultStorage(ok_tag_t, Args&&... args) {
-        if constexpr(!std::is_same<T, unit_t>::value) {
-            new(&m_data) DecayT(std::forward<Args>(args)...);
-        }
-        m_tag = ResultKind::Ok;
-    }
+    constexpr ResultStorageData(ok_tag_t, Args&&... args)
+        : m_buffer(ok_tag, std::forward<Args>(args)...) {}
     template <typename... Args>
-    constexpr ResultStorage(err_tag_t, Args&&... args) {
-        new(&m_data) DecayE(std::forward<Args>(args)...);
-        m_tag = ResultKind::Err;
+    constexpr ResultStorageData(err_tag_t, Args&&... args)
+        : m_buffer(err_tag, std::forward<Args>(args)...) {}
+
+    constexpr const T& get(ok_tag_t) const& noexcept { return m_buffer.ok(); }
+    constexpr T& get(ok_tag_t) & noexcept { return m_buffer.ok(); }
+    constexpr T&& get(ok_tag_t) && noexcept { return std::move(m_buffer.ok()); }
+    constexpr const E& get(err_tag_t) const& noexcept { return m_buffer.err(); }
+    constexpr E& get(err_tag_t) & noexcept { return m_buffer.err(); }
+    constexpr E&& get(err_tag_t) && noexcept {
+        return std::move(m_buffer.err());
     }
 
-    constexpr ResultStorage(Ok<T> val) {
-        if constexpr(!std::is_same<T, unit_t>::value) {
-            new(&m_data) DecayT(std::move(val).value());
-        }
-        m_tag = ResultKind::Ok;
-    }
-    constexpr ResultStorage(Err<E> val) {
-        new(&m_data) DecayE(std::move(val).value());
-        m_tag = ResultKind::Err;
+    constexpr ResultKind kind() const noexcept { return m_buffer.tag(); }
+
+    template <typename Tag, typename... Args>
+    auto& emplace(Tag tag, Args&&... args) {
+        replace(tag, std::forward<Args>(args)...);
+        return get(tag);
     }
 
-    constexpr ResultStorage(const ResultStorage<T, E>& rhs) noexcept(
-            std::is_nothrow_copy_constructible<T>::value&&
-                    std::is_nothrow_copy_constructible<E>::value)
-        : m_tag(rhs.m_tag) {
-        if(kind() == ResultKind::Ok) {
-            if constexpr(!std::is_same<T, unit_t>::value) {
-                new(&m_data) DecayT(rhs.get<T>());
-            }
+protected:
+    constexpr ResultStorageData(no_init_t) noexcept : m_buffer(no_init_t{}) {}
+
+    template <typename Storage>
+    void construct_from(Storage&& rhs) {
+        const ResultKind kind = rhs.kind();
+        if(kind == ResultKind::Ok) {
+            construct(ok_tag, std::forward<Storage>(rhs).get(ok_tag));
         } else {
-            new(&m_data) DecayE(rhs.get<E>());
+            construct(err_tag, std::forward<Storage>(rhs).get(err_tag));
         }
     }
-    constexpr ResultStorage(ResultStorage<T, E>&& rhs) noexcept(
-            std::is_nothrow_move_constructible<T>::value&&
-                    std::is_nothrow_move_constructible<E>::value)
-        : m_tag(rhs.m_tag) {
-        if(kind() == ResultKind::Ok) {
-            if constexpr(!std::is_same<T, unit_t>::value) {
-                new(&m_data) DecayT(std::move(rhs).template get<T>());
+
+    // Assigns in place when both sides hold the same alternative, so that
+    // buffers owned by the current value can be reused. The current value is
+    // only destroyed when the kind changes.
+    template <typename Storage>
+    void assign_from(Storage&& rhs) {
+        if(kind() == rhs.kind()) {
+            if(kind() == ResultKind::Ok) {
+                get(ok_tag) = std::forward<Storage>(rhs).get(ok_tag);
+            } else {
+                get(err_tag) = std::forward<Storage>(rhs).get(err_tag);
             }
+        } else if(rhs.kind() == ResultKind::Ok) {
+            replace(ok_tag, std::forward<Storage>(rhs).get(ok_tag));
         } else {
-            new(&m_data) DecayE(std::move(rhs).template get<E>());
+            replace(err_tag, std::forward<Storage>(rhs).get(err_tag));
         }
     }
-    constexpr ResultStorage& operator=(const ResultStorage<T, E>& rhs) noexcept(
-            std::is_nothrow_copy_assignable<T>::value&&
-                    std::is_nothrow_copy_assignable<E>::value) {
-        destroy();
-        m_tag = rhs.m_tag;
 
-        if(kind() == ResultKind::Ok) {
-            T& val = get<T>();
-            val = rhs.get<T>();
+    // Destroys the current value and constructs the alternative selected by
+    // `tag` in its place. The storage holds a live value even if that throws:
+    // - a construction that cannot throw is done in place;
+    // - else, if a move cannot throw, the new value is built in a temporary
+    //   first, so a throw leaves the old value untouched;
+    // - else, if the kind does not change, the temporary is move assigned;
+    // - else the old value is moved aside, which must not throw, and moved
+    //   back if the construction throws. As with std::expected, this needs
+    //   one of T and E to be nothrow move constructible.
+    template <typename Tag, typename... Args>
+    void replace(Tag tag, Args&&... args) {
+        constexpr bool to_ok = std::is_same<Tag, ok_tag_t>::value;
+        using U = std::conditional_t<to_ok, DecayT, DecayE>;
+        using Other = std::conditional_t<to_ok, DecayE, DecayT>;
+        using OtherTag = std::conditional_t<to_ok, err_tag_t, ok_tag_t>;
+        if constexpr(std::is_nothrow_constructible<U, Args...>::value) {
+            destroy();
+            construct(tag, std::forward<Args>(args)...);
+        } else if constexpr(std::is_nothrow_move_constructible<U>::value) {
+            U value(std::forward<Args>(args)...);
+            destroy();
+            construct(tag, std::move(value));
         } else {
-            E& val = get<E>();
-            val = rhs.get<E>();
+            static_assert(std::is_nothrow_move_constructible<Other>::value,
+                    "changing the kind of a Result needs T or E to be "
+                    "nothrow move constructible");
+            if(kind() == (to_ok ? ResultKind::Ok : ResultKind::Err)) {
+                U value(std::forward<Args>(args)...);
+                get(tag) = std::move(value);
+            } else {
+                Other backup(std::move(get(OtherTag{})));
+                destroy();
+                try {
+                    construct(tag, std::forward<Args>(args)...);
+                } catch(...) {
+                    construct(OtherTag{}, std::move(backup));
+                    throw;
+                }
+            }
         }
     }
-    constexpr ResultStorage& operator=(ResultStorage<T, E>&& rhs) noexcept(
-            std::is_nothrow_move_assignable<T>::value&&
-                    std::is_nothrow_move_assignable<E>::value) {
-        destroy();
-        m_tag = rhs.m_tag;
 
-        if(kind() == ResultKind::Ok) {
-            T& val = get<T>();
-            val = std::move(rhs).template get<T>();
-        } else {
-            E& val = get<E>();
-            val = std::move(rhs).template get<E>();
+    template <typename... Args>
+    void construct(ok_tag_t, Args&&... args) {
+        new(std::addressof(m_buffer.ok())) DecayT(std::forward<Args>(args)...);
+        m_buffer.set_tag(ResultKind::Ok);
+    }
+    template <typename... Args>
+    void construct(err_tag_t, Args&&... args) {
+        new(std::addressof(m_buffer.err())) DecayE(std::forward<Args>(args)...);
+        m_buffer.set_tag(ResultKind::Err);
+    }
+
+    void destroy() noexcept {
+        switch(kind()) {
+        case ResultKind::Ok:
+            get(ok_tag).~T();
+            break;
+        case ResultKind::Err:
+            get(err_tag).~E();
+            break;
         }
     }
 
-    template <typename U>
-    constexpr const U& get() const& noexcept {
-        static_assert(std::is_same<T, U>::value || std::is_same<E, U>::value);
-        return *reinterpret_cast<const U*>(&m_data);
+private:
+    TaggedBuffer<T, E> m_buffer;
+};
+
+template <typename T, typename E,
+        bool = std::is_trivially_destructible<T>::value &&
+                std::is_trivially_destructible<E>::value>
+class ResultStorageDestructor : public ResultStorageData<T, E> {
+public:
+    using ResultStorageData<T, E>::ResultStorageData;
+};
+
+template <typename T, typename E>
+class ResultStorageDestructor<T, E, false> : public ResultStorageData<T, E> {
+public:
+    using ResultStorageData<T, E>::ResultStorageData;
+
+    ResultStorageDestructor(const ResultStorageDestructor&) = default;
+    ResultStorageDestructor(ResultStorageDestructor&&) = default;
+    ResultStorageDestructor& operator=(
+            const ResultStorageDestructor&) = default;
+    ResultStorageDestructor& operator=(ResultStorageDestructor&&) = default;
+
+    ~ResultStorageDestructor() { this->destroy(); }
+};
+
+template <typename T, typename E,
+        bool = std::is_trivially_copy_constructible<T>::value &&
+                std::is_trivially_copy_constructible<E>::value>
+class ResultStorageCopy : public ResultStorageDestructor<T, E> {
+public:
+    using ResultStorageDestructor<T, E>::ResultStorageDestructor;
+};
+
+template <typename T, typename E>
+class ResultStorageCopy<T, E, false> : public ResultStorageDestructor<T, E> {
+public:
+    using ResultStorageDestructor<T, E>::ResultStorageDestructor;
+
+    ResultStorageCopy(const ResultStorageCopy& rhs) noexcept(
+            std::is_nothrow_copy_constructible<T>::value&&
+                    std::is_nothrow_copy_constructible<E>::value)
+        : ResultStorageDestructor<T, E>(no_init_t{}) {
+        this->construct_from(rhs);
     }
-    template <typename U>
-            constexpr U& get() & noexcept {
-        static_assert(std::is_same<T, U>::value || std::is_same<E, U>::value);
-        return *reinterpret_cast<U*>(&m_data);
+    ResultStorageCopy(ResultStorageCopy&&) = default;
+    ResultStorageCopy& operator=(const ResultStorageCopy&) = default;
+    ResultStorageCopy& operator=(ResultStorageCopy&&) = default;
+};
+
+template <typename T, typename E,
+        bool = std::is_trivially_move_constructible<T>::value &&
+                std::is_trivially_move_constructible<E>::value>
+class ResultStorageMove : public ResultStorageCopy<T, E> {
+public:
+    using ResultStorageCopy<T, E>::ResultStorageCopy;
+};
+
+template <typename T, typename E>
+class ResultStorageMove<T, E, false> : public ResultStorageCopy<T, E> {
+public:
+    using ResultStorageCopy<T, E>::ResultStorageCopy;
+
+    ResultStorageMove(const ResultStorageMove&) = default;
+    ResultStorageMove(ResultStorageMove&& rhs) noexcept(
+            std::is_nothrow_move_constructible<T>::value&&
+                    std::is_nothrow_move_constructible<E>::value)
+        : ResultStorageCopy<T, E>(no_init_t{}) {
+        this->construct_from(std::move(rhs));
     }
-    template <typename U>
-            constexpr U&& get() && noexcept {
-        static_assert(std::is_same<T, U>::value || std::is_same<E, U>::value);
-        return std::move(*reinterpret_cast<U*>(&m_data));
+    ResultStorageMove& operator=(const ResultStorageMove&) = default;
+    ResultStorageMove& operator=(ResultStorageMove&&) = default;
+};
+
+template <typename T, typename E,
+        bool = std::is_trivially_copy_assignable<T>::value &&
+                std::is_trivially_copy_constructible<T>::value &&
+                std::is_trivially_destructible<T>::value &&
+                std::is_trivially_copy_assignable<E>::value &&
+                std::is_trivially_copy_constructible<E>::value &&
+                std::is_trivially_destructible<E>::value>
+class ResultStorageCopyAssign : public ResultStorageMove<T, E> {
+public:
+    using ResultStorageMove<T, E>::ResultStorageMove;
+};
+
+template <typename T, typename E>
+class ResultStorageCopyAssign<T, E, false> : public ResultStorageMove<T, E> {
+public:
+    using ResultStorageMove<T, E>::ResultStorageMove;
+
+    ResultStorageCopyAssign(const ResultStorageCopyAssign&) = default;
+    ResultStorageCopyAssign(ResultStorageCopyAssign&&) = default;
+    ResultStorageCopyAssign& operator=(
+            const ResultStorageCopyAssign& rhs) noexcept(
+            std::is_nothrow_copy_assignable<T>::value&&
+                    std::is_nothrow_copy_constructible<T>::value&&
+                            std::is_nothrow_copy_assignable<E>::value&&
+                                    std::is_nothrow_copy_constructible<
+                                            E>::value) {
+        this->assign_from(rhs);
+        return *this;
+    }
+    ResultStorageCopyAssign& operator=(ResultStorageCopyAssign&&) = default;
+};
+
+template <typename T, typename E,
+        bool = std::is_trivially_move_assignable<T>::value &&
+                std::is_trivially_move_constructible<T>::value &&
+                std::is_trivially_destructible<T>::value &&
+                std::is_trivially_move_assignable<E>::value &&
+                std::is_trivially_move_constructible<E>::value &&
+                std::is_trivially_destructible<E>::value>
+class ResultStorageMoveAssign : public ResultStorageCopyAssign<T, E> {
+public:
+    using ResultStorageCopyAssign<T, E>::ResultStorageCopyAssign;
+};
+
+template <typename T, typename E>
+class ResultStorageMoveAssign<T, E, false>
+    : public ResultStorageCopyAssign<T, E> {
+public:
+    using ResultStorageCopyAssign<T, E>::ResultStorageCopyAssign;
+
+    ResultStorageMoveAssign(const ResultStorageMoveAssign&) = default;
+    ResultStorageMoveAssign(ResultStorageMoveAssign&&) = default;
+    ResultStorageMoveAssign& operator=(
+            const ResultStorageMoveAssign&) = default;
+    ResultStorageMoveAssign& operator=(ResultStorageMoveAssign&& rhs) noexcept(
+            std::is_nothrow_move_assignable<T>::value&&
+                    std::is_nothrow_move_constructible<T>::value&&
+                            std::is_nothrow_move_assignable<E>::value&&
+                                    std::is_nothrow_move_constructible<
+                                            E>::value) {
+        this->assign_from(std::move(rhs));
+        return *this;
+    }
+};
+
+// Storage for a Result whose alternative `Inhabited` has a niche and whose
+// other alternative is an empty trivial type. Only the inhabited alternative is
+// stored; it holds the niche value while the Result holds the empty one, which
+// lives in the (empty) base class.
+template <typename T, typename E, ResultKind Inhabited>
+class ResultNicheStorage
+    : private std::conditional_t<Inhabited == ResultKind::Ok, E, T> {
+    using Value = std::conditional_t<Inhabited == ResultKind::Ok, T, E>;
+    using Empty = std::conditional_t<Inhabited == ResultKind::Ok, E, T>;
+    using traits = niche_traits<Value>;
+
+    static constexpr ResultKind EmptyKind = Inhabited == ResultKind::Ok
+            ? ResultKind::Err
+            : ResultKind::Ok;
+
+public:
+    template <typename... Args>
+    constexpr ResultNicheStorage(ok_tag_t, Args&&... args)
+        : ResultNicheStorage(
+                  std::integral_constant<bool, Inhabited == ResultKind::Ok>{},
+                  std::forward<Args>(args)...) {}
+    template <typename... Args>
+    constexpr ResultNicheStorage(err_tag_t, Args&&... args)
+        : ResultNicheStorage(
+                  std::integral_constant<bool, Inhabited == ResultKind::Err>{},
+                  std::forward<Args>(args)...) {}
+
+    constexpr const T& get(ok_tag_t) const& noexcept { return select<T>(*this); }
+    constexpr T& get(ok_tag_t) & noexcept { return select<T>(*this); }
+    constexpr T&& get(ok_tag_t) && noexcept {
+        return std::move(select<T>(*this));
+    }
+    constexpr const E& get(err_tag_t) const& noexcept {
+        return select<E>(*this);
+    }
+    constexpr E& get(err_tag_t) & noexcept { return select<E>(*this); }
+    constexpr E&& get(err_tag_t) && noexcept {
+        return std::move(select<E>(*this));
     }
 
-    constexpr ResultKind kind() const noexcept { return m_tag; }
+    constexpr ResultKind kind() const noexcept {
+        return traits::is_niche(m_value) ? EmptyKind : Inhabited;
+    }
 
-    ~ResultStorage() { destroy(); }
+    template <typename... Args>
+    T& emplace(ok_tag_t, Args&&... args) {
+        emplace_value(std::integral_constant<bool, Inhabited == ResultKind::Ok>{},
+                std::forward<Args>(args)...);
+        return get(ok_tag);
+    }
+    template <typename... Args>
+    E& emplace(err_tag_t, Args&&... args) {
+        emplace_value(
+                std::integral_constant<bool, Inhabited == ResultKind::Err>{},
+                std::forward<Args>(args)...);
+        return get(err_tag);
+    }
 
 private:
-    void destroy() {
-        switch(m_tag) {
-        case ResultKind::Ok:
-            get<T>().~T();
-            break;
-        case ResultKind::Err:
-            get<E>().~E();
-            break;
+    template <typename U, typename Self>
+    static constexpr auto& select(Self& self) noexcept {
+        if constexpr(std::is_same<U, Value>::value) {
+            return self.m_value;
+        } else {
+            using Base = std::conditional_t<std::is_const<Self>::value,
+                    const Empty,
+                    Empty>;
+            return static_cast<Base&>(self);
         }
     }
 
-    data_type m_data;
-    ResultKind m_tag;
+    template <typename... Args>
+    constexpr ResultNicheStorage(std::true_type, Args&&... args)
+        : m_value(init_arg(std::forward<Args>(args))...) {}
+    template <typename... Args>
+    constexpr ResultNicheStorage(std::false_type, Args&&...)
+        : m_value(traits::niche_value()) {}
+
+    template <typename... Args>
+    void emplace_value(std::true_type, Args&&... args) {
+        if constexpr(std::is_nothrow_constructible<Value, Args...>::value) {
+            m_value.~Value();
+            new(std::addressof(m_value)) Value(std::forward<Args>(args)...);
+        } else {
+            m_value = Value(std::forward<Args>(args)...);
+        }
+    }
+    template <typename... Args>
+    void emplace_value(std::false_type, Args&&...) {
+        m_value = traits::niche_value();
+    }
+
+    Value m_value;
+};
+
+template <typename T, typename E>
+using ResultStorageBase =
+        std::conditional_t<storage_layout<T, E> == StorageLayout::NicheInOk,
+                ResultNicheStorage<T, E, ResultKind::Ok>,
+                std::conditional_t<storage_layout<T, E> ==
+                                StorageLayout::NicheInErr,
+                        ResultNicheStorage<T, E, ResultKind::Err>,
+                        ResultStorageMoveAssign<T, E>>>;
+
+template <typename T, typename E>
+class ResultStorage : public ResultStorageBase<T, E> {
+    using Base = ResultStorageBase<T, E>;
+
+public:
+    using value_type = T;
+    using error_type = E;
+
+    using Base::Base;
+
+    ResultStorage() = delete;
 };
 
 } // namespace details
@@ -255,14 +926,41 @@ public:
             "Cannot create a Result<T, E> object with E=void. You want an "
             "optional<T>.");
 
-    constexpr Result() {
+    constexpr Result() : m_storage(ok_tag) {
         static_assert(std::is_default_constructible<T>::value,
                 "Result<T, E> may only be default constructed if T is default "
                 "constructible.");
-        m_storage = Ok(T());
     }
-    constexpr Result(Ok<T> value) : m_storage(std::move(value)) {}
-    constexpr Result(Err<E> value) : m_storage(std::move(value)) {}
+    /// Converts from `Ok<U>` or `Err<U>` for any `U` convertible to `T` or
+    /// `E`. Converting from an rvalue `Ok` or `Err` costs one move from the
+    /// wrapper into storage, on top of the move that built the wrapper, so
+    /// `return Ok(std::move(big));` moves twice. Construct with `ok_tag` or
+    /// `err_tag` to move the value only once.
+    template <typename U,
+            std::enable_if_t<std::is_convertible<U&&, T>::value, int> = 0>
+    constexpr Result(Ok<U>&& value)
+        : m_storage(ok_tag, std::move(value).value()) {}
+    template <typename U,
+            std::enable_if_t<std::is_convertible<const U&, T>::value, int> = 0>
+    constexpr Result(const Ok<U>& value) : m_storage(ok_tag, value.value()) {}
+    template <typename U,
+            std::enable_if_t<std::is_convertible<U&&, E>::value, int> = 0>
+    constexpr Result(Err<U>&& value)
+        : m_storage(err_tag, std::move(value).value()) {}
+    template <typename U,
+            std::enable_if_t<std::is_convertible<const U&, E>::value, int> = 0>
+    constexpr Result(const Err<U>& value) : m_storage(err_tag, value.value()) {}
+    /// Converts from a `Result<U, F>` rvalue whose value converts to `T` and
+    /// whose error converts to `E` through `convert_error<F, E>`. The value
+    /// or error is moved once, straight into the new `Result`.
+    template <typename U, typename F,
+            std::enable_if_t<!(std::is_same<U, T>::value &&
+                                     std::is_same<F, E>::value) &&
+                            std::is_convertible<U&&, T>::value &&
+                            details::error_converts<F, E>,
+                    int> = 0>
+    constexpr Result(Result<U, F>&& other)
+        : m_storage(convert_from(std::move(other))) {}
 
     template <typename... Args>
     constexpr Result(ok_tag_t, Args && ... args)
@@ -286,6 +984,25 @@ public:
 
     constexpr Result<T, E> clone() const { return *this; }
 
+    // ===== Modifiers ===== {{{
+
+    /// Replaces the contents with an `Ok` constructed in place from `args`.
+    ///
+    /// If constructing `T` throws, the `Result` keeps its old contents; when
+    /// it already held an `Ok` and moving `T` may throw too, the old value is
+    /// only as intact as `T`'s move assignment leaves it.
+    template <typename... Args>
+    T& emplace_ok(Args&&... args) {
+        return m_storage.emplace(ok_tag, std::forward<Args>(args)...);
+    }
+    /// Replaces the contents with an `Err` constructed in place from `args`.
+    template <typename... Args>
+    E& emplace_err(Args&&... args) {
+        return m_storage.emplace(err_tag, std::forward<Args>(args)...);
+    }
+
+    // }}}
+
     constexpr bool is_ok() const noexcept {
         return m_storage.kind() == ResultKind::Ok;
     }
@@ -298,10 +1015,10 @@ public:
 
     constexpr bool operator==(const Ok<T>& other) const noexcept {
         if constexpr(std::is_same<T, unit_t>::value) {
-            return true;
+            return kind() == ResultKind::Ok;
         } else {
             return kind() == ResultKind::Ok &&
-                    m_storage.template get<T>() == other.value();
+                    m_storage.get(ok_tag) == other.value();
         }
     }
     constexpr bool operator!=(const Ok<T>& other) const noexcept {
@@ -309,7 +1026,7 @@ public:
     }
     constexpr bool operator==(const Err<E>& other) const noexcept {
         return kind() == ResultKind::Err &&
-                m_storage.template get<E>() == other.value();
+                m_storage.get(err_tag) == other.value();
     }
     constexpr bool operator!=(const Err<E>& other) const noexcept {
         return !(*this == other);
@@ -322,12 +1039,12 @@ public:
             if constexpr(std::is_same<T, unit_t>::value) {
                 return true;
             } else {
-                return m_storage.template get<T>() ==
-                        other.m_storage.template get<T>();
+                return m_storage.get(ok_tag) ==
+                        other.m_storage.get(ok_tag);
             }
         } else {
-            return m_storage.template get<E>() ==
-                    other.m_storage.template get<E>();
+            return m_storage.get(err_tag) ==
+                    other.m_storage.get(err_tag);
         }
         return false;
     }
@@ -353,7 +1070,7 @@ public:
     }
     constexpr optional<T> ok()&& {
         if(is_ok()) {
-            return ok_unchecked();
+            return std::move(*this).ok_unchecked();
         } else {
             return nullopt;
         }
@@ -374,209 +1091,877 @@ public:
     }
     constexpr optional<E> err() && {
         if(is_err()) {
-            return err_unchecked();
+            return std::move(*this).err_unchecked();
         } else {
             return nullopt;
         }
     }
 
-    constexpr const E& try_err() const {
+    constexpr const E& try_err(source_location location =
+                    source_location::current()) const {
         if(!is_err()) {
-            details::terminate("Called `try_err` on an Ok value");
+            details::panic("Called `try_err` on an Ok value",
+                    location.file,
+                    location.line,
+                    location.function);
         }
         return err_unchecked();
     }
-    constexpr E& try_err() {
+    constexpr E& try_err(source_location location =
+                    source_location::current()) {
         if(!is_err()) {
-            details::terminate("Called `try_err` on an Ok value");
+            details::panic("Called `try_err` on an Ok value",
+                    location.file,
+                    location.line,
+                    location.function);
         }
         return err_unchecked();
     }
-    constexpr const T& try_ok() const {
+    constexpr const T& try_ok(source_location location =
+                    source_location::current()) const {
         if(!is_ok()) {
-            details::terminate("Called `try_ok` on an Err value");
+            details::panic("Called `try_ok` on an Err value",
+                    location.file,
+                    location.line,
+                    location.function);
         }
         return ok_unchecked();
     }
-    constexpr T& try_ok() {
+    constexpr T& try_ok(source_location location =
+                    source_location::current()) {
         if(!is_ok()) {
-            details::terminate("Called `try_ok` on an Err value");
+            details::panic("Called `try_ok` on an Err value",
+                    location.file,
+                    location.line,
+                    location.function);
         }
         return ok_unchecked();
     }
 
-    constexpr T&& unwrap() {
-        if(!is_ok()) {
-            details::terminate("Called `unwrap` on an Err value");
-        }
-        return std::move(*this).ok_unchecked();
+    // The consuming accessors return by value: the `&&` overloads move the
+    // payload out and the `const&` overloads copy it, so the result never
+    // refers into the `Result` or into a temporary.
+
+    constexpr T unwrap(
+            source_location location = source_location::current()) const& {
+        return expect_impl(
+                *this, "Called `unwrap` on an Err value", location);
     }
-    constexpr T&& unwrap_or(T && value) {
-        if(!is_ok()) {
+    constexpr T unwrap(
+            source_location location = source_location::current()) && {
+        return expect_impl(
+                std::move(*this), "Called `unwrap` on an Err value", location);
+    }
+    constexpr T unwrap_or(T value) const& {
+        if(!details::hint_ok<E>(is_ok())) {
+            return value;
+        }
+        return ok_unchecked();
+    }
+    constexpr T unwrap_or(T value) && {
+        if(!details::hint_ok<E>(is_ok())) {
             return value;
         }
         return std::move(*this).ok_unchecked();
     }
-    constexpr T&& unwrap_or_default() {
+    /// Returns the `Ok` value, or the result of calling `fn` with the error.
+    /// `fn` is only called, and the fallback only built, on an `Err`.
+    template <typename F,
+            std::enable_if_t<std::is_invocable_r<T, F, const E&>::value,
+                    int> = 0>
+    constexpr T unwrap_or_else(F && fn) const& {
+        if(!details::hint_ok<E>(is_ok())) {
+            return std::forward<F>(fn)(err_unchecked());
+        }
+        return ok_unchecked();
+    }
+    template <typename F,
+            std::enable_if_t<std::is_invocable_r<T, F, E>::value, int> = 0>
+    constexpr T unwrap_or_else(F && fn) && {
+        if(!details::hint_ok<E>(is_ok())) {
+            return std::forward<F>(fn)(std::move(*this).err_unchecked());
+        }
+        return std::move(*this).ok_unchecked();
+    }
+    constexpr T unwrap_or_default() const& {
         static_assert(std::is_default_constructible<T>::value,
                 "`unwrap_or_default` requires T to be default constructible");
-        if(!is_ok()) {
+        if(!details::hint_ok<E>(is_ok())) {
+            return T();
+        }
+        return ok_unchecked();
+    }
+    constexpr T unwrap_or_default() && {
+        static_assert(std::is_default_constructible<T>::value,
+                "`unwrap_or_default` requires T to be default constructible");
+        if(!details::hint_ok<E>(is_ok())) {
             return T();
         }
         return std::move(*this).ok_unchecked();
     }
-    constexpr E&& unwrap_err() {
+    constexpr E unwrap_err(
+            source_location location = source_location::current()) const& {
+        return expect_err_impl(
+                *this, "Called `unwrap_err` on an Ok value", location);
+    }
+    constexpr E unwrap_err(
+            source_location location = source_location::current()) && {
+        return expect_err_impl(std::move(*this),
+                "Called `unwrap_err` on an Ok value",
+                location);
+    }
+    constexpr E unwrap_err_or(E error) const& {
         if(!is_err()) {
-            details::terminate("Called `unwrap_err` on an Err value");
+            return error;
         }
-        return std::move(*this).err_unchecked();
+        return err_unchecked();
     }
-    constexpr E&& unwrap_err_or(E && error) {
+    constexpr E unwrap_err_or(E error) && {
         if(!is_err()) {
             return error;
         }
         return std::move(*this).err_unchecked();
     }
-    constexpr E&& unwrap_err_or_default() {
-        static_assert(std::is_default_constructible<T>::value,
-                "`unwrap_err_or_default` requires E to be default "
-                "constructible");
+    template <typename F,
+            std::enable_if_t<std::is_invocable_r<E, F, const T&>::value,
+                    int> = 0>
+    constexpr E unwrap_err_or_else(F && fn) const& {
         if(!is_err()) {
-            return E();
+            return std::forward<F>(fn)(ok_unchecked());
+        }
+        return err_unchecked();
+    }
+    template <typename F,
+            std::enable_if_t<std::is_invocable_r<E, F, T>::value, int> = 0>
+    constexpr E unwrap_err_or_else(F && fn) && {
+        if(!is_err()) {
+            return std::forward<F>(fn)(std::move(*this).ok_unchecked());
         }
         return std::move(*this).err_unchecked();
     }
-
-    constexpr T&& expect(const std::string_view& message) {
-        if(!is_ok()) {
-            details::terminate(message);
+    constexpr E unwrap_err_or_default() const& {
+        static_assert(std::is_default_constructible<E>::value,
+                "`unwrap_err_or_default` requires E to be default "
+                "constructible");
+        if(!is_err()) {
+            return E();
         }
-        return std::move(*this).ok_unchecked();
-        ;
+        return err_unchecked();
     }
-    constexpr E&& expect_err(const std::string_view& message) {
+    constexpr E unwrap_err_or_default() && {
+        static_assert(std::is_default_constructible<E>::value,
+                "`unwrap_err_or_default` requires E to be default "
+                "constructible");
         if(!is_err()) {
-            details::terminate(message);
+            return E();
         }
         return std::move(*this).err_unchecked();
-        ;
+    }
+
+    constexpr T expect(std::string_view message,
+            source_location location = source_location::current()) const& {
+        return expect_impl(*this, message, location);
+    }
+    constexpr T expect(std::string_view message,
+            source_location location = source_location::current()) && {
+        return expect_impl(std::move(*this), message, location);
+    }
+    constexpr E expect_err(std::string_view message,
+            source_location location = source_location::current()) const& {
+        return expect_err_impl(*this, message, location);
+    }
+    constexpr E expect_err(std::string_view message,
+            source_location location = source_location::current()) && {
+        return expect_err_impl(std::move(*this), message, location);
     }
 
     // }}}
     // ===== Unsafe accessors ===== {{{
 
     constexpr const T& ok_unchecked() const& noexcept {
-        return m_storage.template get<T>();
+        return m_storage.get(ok_tag);
     }
     constexpr const E& err_unchecked() const& noexcept {
-        return m_storage.template get<E>();
+        return m_storage.get(err_tag);
     }
     constexpr T& ok_unchecked() & noexcept {
-        return m_storage.template get<T>();
+        return m_storage.get(ok_tag);
     }
     constexpr E& err_unchecked() & noexcept {
-        return m_storage.template get<E>();
+        return m_storage.get(err_tag);
     }
     constexpr T&& ok_unchecked() && noexcept {
-        return std::move(m_storage).template get<T>();
+        return std::move(m_storage).get(ok_tag);
     }
     constexpr E&& err_unchecked() && noexcept {
-        return std::move(m_storage).template get<E>();
+        return std::move(m_storage).get(err_tag);
+    }
+
+    /// Returns the `Ok` value without checking the kind, like `unwrap()` for a
+    /// `Result` that is already known to be `Ok`.
+    ///
+    /// Calling it on an `Err` is undefined behavior. The kind check is turned
+    /// into an optimizer assumption instead, so the compiler may also drop
+    /// earlier `is_ok()` checks on the same `Result`.
+    constexpr T unwrap_unchecked() const& noexcept(
+            std::is_nothrow_copy_constructible<T>::value) {
+        details::assume(is_ok());
+        return ok_unchecked();
+    }
+    constexpr T unwrap_unchecked() && noexcept(
+            std::is_nothrow_move_constructible<T>::value) {
+        details::assume(is_ok());
+        return std::move(*this).ok_unchecked();
+    }
+    constexpr E unwrap_err_unchecked() const& noexcept(
+            std::is_nothrow_copy_constructible<E>::value) {
+        details::assume(is_err());
+        return err_unchecked();
+    }
+    constexpr E unwrap_err_unchecked() && noexcept(
+            std::is_nothrow_move_constructible<E>::value) {
+        details::assume(is_err());
+        return std::move(*this).err_unchecked();
     }
 
     // }}}
     // ===== Combinators and adapters ===== {{{
+    //
+    // Every combinator has `const&`, `&` and `&&` overloads. On an lvalue the
+    // payload is passed to `fn` by reference and the value carried through
+    // unchanged is copied; on an rvalue both are moved, so a chain of rvalue
+    // combinators moves each payload exactly once per step.
+
+    template <typename F,
+            typename T2 = std::invoke_result_t<F, const T&>,
+            std::enable_if_t<std::is_invocable_r<T2, F, const T&>::value,
+                    int> = 0>
+    constexpr Result<T2, E> map(F && map_fn) const& {
+        return map_impl<T2>(*this, std::forward<F>(map_fn));
+    }
+    template <typename F,
+            typename T2 = std::invoke_result_t<F, T&>,
+            std::enable_if_t<std::is_invocable_r<T2, F, T&>::value, int> = 0>
+    constexpr Result<T2, E> map(F && map_fn) & {
+        return map_impl<T2>(*this, std::forward<F>(map_fn));
+    }
     template <typename F,
             typename T2 = std::invoke_result_t<F, T>,
             std::enable_if_t<std::is_invocable_r<T2, F, T>::value, int> = 0>
-    Result<T2, E> map(F && map_fn) const {
-        if(is_ok()) {
-            return Result<T2, E>(Ok(map_fn(std::move(*this).ok_unchecked())));
-        } else {
-            return Result<T2, E>(Err(std::move(*this).err_unchecked()));
-        }
+    constexpr Result<T2, E> map(F && map_fn) && {
+        return map_impl<T2>(std::move(*this), std::forward<F>(map_fn));
     }
 
+    template <typename F,
+            typename E2 = std::invoke_result_t<F, const E&>,
+            std::enable_if_t<std::is_invocable_r<E2, F, const E&>::value,
+                    int> = 0>
+    constexpr Result<T, E2> map_err(F && map_fn) const& {
+        return map_err_impl<E2>(*this, std::forward<F>(map_fn));
+    }
+    template <typename F,
+            typename E2 = std::invoke_result_t<F, E&>,
+            std::enable_if_t<std::is_invocable_r<E2, F, E&>::value, int> = 0>
+    constexpr Result<T, E2> map_err(F && map_fn) & {
+        return map_err_impl<E2>(*this, std::forward<F>(map_fn));
+    }
     template <typename F,
             typename E2 = std::invoke_result_t<F, E>,
             std::enable_if_t<std::is_invocable_r<E2, F, E>::value, int> = 0>
-    Result<T, E2> map_err(F && map_fn) {
-        if(is_ok()) {
-            return Result<T, E2>(Ok(std::move(*this).ok_unchecked()));
-        } else {
-            return Result<T, E2>(Err(map_fn(std::move(*this).err_unchecked())));
-        }
+    constexpr Result<T, E2> map_err(F && map_fn) && {
+        return map_err_impl<E2>(std::move(*this), std::forward<F>(map_fn));
+    }
+
+    /// Applies `fn` to the `Ok` value, or returns `default_value` on an `Err`.
+    template <typename U, typename F,
+            std::enable_if_t<std::is_invocable_r<U, F, const T&>::value,
+                    int> = 0>
+    constexpr U map_or(U default_value, F && fn) const& {
+        return map_or_impl(
+                *this, std::move(default_value), std::forward<F>(fn));
+    }
+    template <typename U, typename F,
+            std::enable_if_t<std::is_invocable_r<U, F, T&>::value, int> = 0>
+    constexpr U map_or(U default_value, F && fn) & {
+        return map_or_impl(
+                *this, std::move(default_value), std::forward<F>(fn));
+    }
+    template <typename U, typename F,
+            std::enable_if_t<std::is_invocable_r<U, F, T>::value, int> = 0>
+    constexpr U map_or(U default_value, F && fn) && {
+        return map_or_impl(std::move(*this),
+                std::move(default_value),
+                std::forward<F>(fn));
+    }
+
+    /// Applies `ok_fn` to the `Ok` value or `err_fn` to the error. Both must
+    /// return the same type. Unlike `map_or`, the fallback is only computed on
+    /// an `Err`.
+    template <typename D, typename F,
+            typename U = std::invoke_result_t<F, const T&>,
+            std::enable_if_t<std::is_invocable_r<U, D, const E&>::value,
+                    int> = 0>
+    constexpr U map_or_else(D && err_fn, F && ok_fn) const& {
+        return map_or_else_impl<U>(
+                *this, std::forward<D>(err_fn), std::forward<F>(ok_fn));
+    }
+    template <typename D, typename F,
+            typename U = std::invoke_result_t<F, T&>,
+            std::enable_if_t<std::is_invocable_r<U, D, E&>::value, int> = 0>
+    constexpr U map_or_else(D && err_fn, F && ok_fn) & {
+        return map_or_else_impl<U>(
+                *this, std::forward<D>(err_fn), std::forward<F>(ok_fn));
+    }
+    template <typename D, typename F,
+            typename U = std::invoke_result_t<F, T>,
+            std::enable_if_t<std::is_invocable_r<U, D, E>::value, int> = 0>
+    constexpr U map_or_else(D && err_fn, F && ok_fn) && {
+        return map_or_else_impl<U>(std::move(*this),
+                std::forward<D>(err_fn),
+                std::forward<F>(ok_fn));
     }
 
     template <typename T2>
-    Result<T2, E> and_(Result<T2, E> other) {
-        if(is_ok()) {
-            return other;
-        } else {
-            return Result<T2, E>(Err(std::move(*this).err_unchecked()));
-        }
+    constexpr Result<T2, E> and_(Result<T2, E> other) const& {
+        return and_impl(*this, std::move(other));
+    }
+    template <typename T2>
+    constexpr Result<T2, E> and_(Result<T2, E> other) & {
+        return and_impl(*this, std::move(other));
+    }
+    template <typename T2>
+    constexpr Result<T2, E> and_(Result<T2, E> other) && {
+        return and_impl(std::move(*this), std::move(other));
+    }
+
+    /// Lazy `and_`: `fn` takes no arguments and is only called on an `Ok`.
+    template <typename F,
+            typename T2 = typename std::invoke_result_t<F>::value_type,
+            std::enable_if_t<std::is_invocable_r<Result<T2, E>, F>::value,
+                    int> = 0>
+    constexpr Result<T2, E> and_(F && fn) const& {
+        return and_lazy_impl<T2>(*this, std::forward<F>(fn));
+    }
+    template <typename F,
+            typename T2 = typename std::invoke_result_t<F>::value_type,
+            std::enable_if_t<std::is_invocable_r<Result<T2, E>, F>::value,
+                    int> = 0>
+    constexpr Result<T2, E> and_(F && fn) & {
+        return and_lazy_impl<T2>(*this, std::forward<F>(fn));
+    }
+    template <typename F,
+            typename T2 = typename std::invoke_result_t<F>::value_type,
+            std::enable_if_t<std::is_invocable_r<Result<T2, E>, F>::value,
+                    int> = 0>
+    constexpr Result<T2, E> and_(F && fn) && {
+        return and_lazy_impl<T2>(std::move(*this), std::forward<F>(fn));
     }
 
+    template <typename F,
+            typename T2 =
+                    typename std::invoke_result_t<F, const T&>::value_type,
+            std::enable_if_t<
+                    std::is_invocable_r<Result<T2, E>, F, const T&>::value,
+                    int> = 0>
+    constexpr Result<T2, E> and_then(F && fn) const& {
+        return and_then_impl<T2>(*this, std::forward<F>(fn));
+    }
+    template <typename F,
+            typename T2 = typename std::invoke_result_t<F, T&>::value_type,
+            std::enable_if_t<std::is_invocable_r<Result<T2, E>, F, T&>::value,
+                    int> = 0>
+    constexpr Result<T2, E> and_then(F && fn) & {
+        return and_then_impl<T2>(*this, std::forward<F>(fn));
+    }
     template <typename F,
             typename T2 = typename std::invoke_result_t<F, T>::value_type,
             std::enable_if_t<std::is_invocable_r<Result<T2, E>, F, T>::value,
                     int> = 0>
-    Result<T2, E> and_then(F && fn) {
-        if(is_ok()) {
-            return fn(std::move(*this).ok_unchecked());
+    constexpr Result<T2, E> and_then(F && fn) && {
+        return and_then_impl<T2>(std::move(*this), std::forward<F>(fn));
+    }
+
+    template <typename E2>
+    constexpr Result<T, E2> or_(Result<T, E2> other) const& {
+        return or_impl(*this, std::move(other));
+    }
+    template <typename E2>
+    constexpr Result<T, E2> or_(Result<T, E2> other) & {
+        return or_impl(*this, std::move(other));
+    }
+    template <typename E2>
+    constexpr Result<T, E2> or_(Result<T, E2> other) && {
+        return or_impl(std::move(*this), std::move(other));
+    }
+
+    /// Lazy `or_`: `fn` takes no arguments and is only called on an `Err`.
+    template <typename F,
+            typename E2 = typename std::invoke_result_t<F>::error_type,
+            std::enable_if_t<std::is_invocable_r<Result<T, E2>, F>::value,
+                    int> = 0>
+    constexpr Result<T, E2> or_(F && fn) const& {
+        return or_lazy_impl<E2>(*this, std::forward<F>(fn));
+    }
+    template <typename F,
+            typename E2 = typename std::invoke_result_t<F>::error_type,
+            std::enable_if_t<std::is_invocable_r<Result<T, E2>, F>::value,
+                    int> = 0>
+    constexpr Result<T, E2> or_(F && fn) & {
+        return or_lazy_impl<E2>(*this, std::forward<F>(fn));
+    }
+    template <typename F,
+            typename E2 = typename std::invoke_result_t<F>::error_type,
+            std::enable_if_t<std::is_invocable_r<Result<T, E2>, F>::value,
+                    int> = 0>
+    constexpr Result<T, E2> or_(F && fn) && {
+        return or_lazy_impl<E2>(std::move(*this), std::forward<F>(fn));
+    }
+
+    template <typename F,
+            typename E2 =
+                    typename std::invoke_result_t<F, const E&>::error_type,
+            std::enable_if_t<
+                    std::is_invocable_r<Result<T, E2>, F, const E&>::value,
+                    int> = 0>
+    constexpr Result<T, E2> or_else(F && fn) const& {
+        return or_else_impl<E2>(*this, std::forward<F>(fn));
+    }
+    template <typename F,
+            typename E2 = typename std::invoke_result_t<F, E&>::error_type,
+            std::enable_if_t<std::is_invocable_r<Result<T, E2>, F, E&>::value,
+                    int> = 0>
+    constexpr Result<T, E2> or_else(F && fn) & {
+        return or_else_impl<E2>(*this, std::forward<F>(fn));
+    }
+    template <typename F,
+            typename E2 = typename std::invoke_result_t<F, E>::error_type,
+            std::enable_if_t<std::is_invocable_r<Result<T, E2>, F, E>::value,
+                    int> = 0>
+    constexpr Result<T, E2> or_else(F && fn) && {
+        return or_else_impl<E2>(std::move(*this), std::forward<F>(fn));
+    }
+
+    /// Starts a `LazyResult` pipeline that moves out of this `Result` when it
+    /// is collected. The pipeline refers to this `Result`, which must outlive
+    /// it.
+    constexpr LazyResult<T, E, T, E> lazy() & noexcept {
+        return LazyResult<T, E, T, E>(this, std::tuple<>());
+    }
+    /// A pipeline over a temporary would outlive it once stored in a
+    /// variable.
+    LazyResult<T, E, T, E> lazy() && = delete;
+
+    // }}}
+
+private:
+    template <typename Self>
+    static constexpr T expect_impl(Self&& self,
+            std::string_view message,
+            const source_location& location) {
+        if(!self.is_ok()) {
+            details::panic(message,
+                    location.file,
+                    location.line,
+                    location.function);
+        }
+        return std::forward<Self>(self).ok_unchecked();
+    }
+    template <typename Self>
+    static constexpr E expect_err_impl(Self&& self,
+            std::string_view message,
+            const source_location& location) {
+        if(!self.is_err()) {
+            details::panic(message,
+                    location.file,
+                    location.line,
+                    location.function);
+        }
+        return std::forward<Self>(self).err_unchecked();
+    }
+
+    // Shared bodies of the combinator overloads. `Self` is `const Result&`,
+    // `Result&` or `Result`, and forwarding it picks the matching
+    // `ok_unchecked()`/`err_unchecked()` overload.
+    template <typename T2, typename Self, typename F>
+    static constexpr Result<T2, E> map_impl(Self&& self, F&& map_fn) {
+        if(details::hint_ok<E>(self.is_ok())) {
+            return Result<T2, E>(ok_tag,
+                    std::forward<F>(map_fn)(
+                            std::forward<Self>(self).ok_unchecked()));
         } else {
-            return Result<T2, E>(Err(std::move(*this).err_unchecked()));
+            return Result<T2, E>(
+                    err_tag, std::forward<Self>(self).err_unchecked());
         }
     }
 
-    template <typename E2>
-    Result<T, E2> or_(Result<T, E2> other) {
-        if(is_err()) {
-            return other;
+    template <typename E2, typename Self, typename F>
+    static constexpr Result<T, E2> map_err_impl(Self&& self, F&& map_fn) {
+        if(details::hint_ok<E>(self.is_ok())) {
+            return Result<T, E2>(
+                    ok_tag, std::forward<Self>(self).ok_unchecked());
+        } else {
+            return Result<T, E2>(err_tag,
+                    std::forward<F>(map_fn)(
+                            std::forward<Self>(self).err_unchecked()));
+        }
+    }
+
+    template <typename Self, typename U, typename F>
+    static constexpr U map_or_impl(Self&& self, U&& default_value, F&& fn) {
+        if(details::hint_ok<E>(self.is_ok())) {
+            return std::forward<F>(fn)(std::forward<Self>(self).ok_unchecked());
         } else {
-            return Result<T, E2>(Ok(std::move(*this).ok_unchecked()));
+            return std::move(default_value);
         }
     }
 
+    template <typename U, typename Self, typename D, typename F>
+    static constexpr U map_or_else_impl(Self&& self, D&& err_fn, F&& ok_fn) {
+        if(details::hint_ok<E>(self.is_ok())) {
+            return std::forward<F>(ok_fn)(
+                    std::forward<Self>(self).ok_unchecked());
+        } else {
+            return std::forward<D>(err_fn)(
+                    std::forward<Self>(self).err_unchecked());
+        }
+    }
+
+    template <typename T2, typename Self, typename F>
+    static constexpr Result<T2, E> and_lazy_impl(Self&& self, F&& fn) {
+        if(details::hint_ok<E>(self.is_ok())) {
+            return std::forward<F>(fn)();
+        } else {
+            return Result<T2, E>(
+                    err_tag, std::forward<Self>(self).err_unchecked());
+        }
+    }
+
+    template <typename E2, typename Self, typename F>
+    static constexpr Result<T, E2> or_lazy_impl(Self&& self, F&& fn) {
+        if(details::hint_err<E>(self.is_err())) {
+            return std::forward<F>(fn)();
+        } else {
+            return Result<T, E2>(
+                    ok_tag, std::forward<Self>(self).ok_unchecked());
+        }
+    }
+
+    template <typename Self, typename T2>
+    static constexpr Result<T2, E> and_impl(
+            Self&& self, Result<T2, E>&& other) {
+        if(details::hint_ok<E>(self.is_ok())) {
+            return std::move(other);
+        } else {
+            return Result<T2, E>(
+                    err_tag, std::forward<Self>(self).err_unchecked());
+        }
+    }
+
+    template <typename U, typename F>
+    static constexpr details::ResultStorage<T, E> convert_from(
+            Result<U, F>&& other) {
+        if(details::hint_ok<F>(other.is_ok())) {
+            return details::ResultStorage<T, E>(
+                    ok_tag, std::move(other).ok_unchecked());
+        } else {
+            return details::ResultStorage<T, E>(err_tag,
+                    details::convert_err<E>(std::move(other).err_unchecked()));
+        }
+    }
+
+    template <typename T2, typename Self, typename F>
+    static constexpr Result<T2, E> and_then_impl(Self&& self, F&& fn) {
+        if(details::hint_ok<E>(self.is_ok())) {
+            return std::forward<F>(fn)(std::forward<Self>(self).ok_unchecked());
+        } else {
+            return Result<T2, E>(
+                    err_tag, std::forward<Self>(self).err_unchecked());
+        }
+    }
+
+    template <typename Self, typename E2>
+    static constexpr Result<T, E2> or_impl(
+            Self&& self, Result<T, E2>&& other) {
+        if(details::hint_err<E>(self.is_err())) {
+            return std::move(other);
+        } else {
+            return Result<T, E2>(
+                    ok_tag, std::forward<Self>(self).ok_unchecked());
+        }
+    }
+
+    template <typename E2, typename Self, typename F>
+    static constexpr Result<T, E2> or_else_impl(Self&& self, F&& fn) {
+        if(details::hint_err<E>(self.is_err())) {
+            return std::forward<F>(fn)(
+                    std::forward<Self>(self).err_unchecked());
+        } else {
+            return Result<T, E2>(
+                    ok_tag, std::forward<Self>(self).ok_unchecked());
+        }
+    }
+
+    details::ResultStorage<T, E> m_storage;
+};
+
+namespace details {
+
+enum class LazyStep { Map, MapErr, AndThen, OrElse };
+
+// `Err` is the error type of the pipeline at an `AndThen` stage, which the
+// error of the continuation's result is converted to.
+template <LazyStep Step, typename F, typename Err = void>
+struct LazyStage {
+    static constexpr LazyStep step = Step;
+    using error_type = Err;
+    F fn;
+};
+
+// Passes `error` on unchanged if it is already an `E`, and otherwise converts
+// it through `convert_error`.
+template <typename E, typename X>
+constexpr decltype(auto) as_error(X&& error) {
+    if constexpr(std::is_same<std::decay_t<X>, E>::value) {
+        return std::forward<X>(error);
+    } else {
+        return init_arg(convert_err<E>(std::forward<X>(error)));
+    }
+}
+
+} // namespace details
+
+/// A chain of combinators over a `Result` that is evaluated only by
+/// `collect()`.
+///
+/// Created by `Result::lazy()`. `map`, `map_err`, `and_then` and `or_else`
+/// append a stage to the pipeline instead of building an intermediate
+/// `Result`. `collect()` branches once on the kind of the source and then runs
+/// the stages that apply to that side, passing the value from one stage to the
+/// next by reference. Only the results of `and_then` and `or_else` are
+/// inspected again, since they may switch sides; the final value is moved into
+/// the returned `Result` exactly once.
+///
+/// The pipeline refers to the `Result` it was created from and moves out of it
+/// in `collect()`, so it can only be started from an lvalue that outlives it:
+///
+/// ```cpp
+/// auto parsed = parse(text);
+/// auto r = parsed.lazy().map(f).and_then(g).map_err(h).collect();
+/// ```
+template <typename T0, typename E0, typename T, typename E, typename... Stages>
+class [[nodiscard]] LazyResult {
+public:
+    using value_type = T;
+    using error_type = E;
+
+    template <typename F, typename T2 = std::invoke_result_t<F, T>>
+    constexpr LazyResult<T0, E0, T2, E, Stages...,
+            details::LazyStage<details::LazyStep::Map, std::decay_t<F>>>
+    map(F && fn) && {
+        return append<T2, E, details::LazyStep::Map>(std::forward<F>(fn));
+    }
+
+    template <typename F, typename E2 = std::invoke_result_t<F, E>>
+    constexpr LazyResult<T0, E0, T, E2, Stages...,
+            details::LazyStage<details::LazyStep::MapErr, std::decay_t<F>>>
+    map_err(F && fn) && {
+        return append<T, E2, details::LazyStep::MapErr>(std::forward<F>(fn));
+    }
+
+    template <typename F,
+            typename T2 = typename std::invoke_result_t<F, T>::value_type,
+            std::enable_if_t<std::is_invocable_r<Result<T2, E>, F, T>::value,
+                    int> = 0>
+    constexpr LazyResult<T0, E0, T2, E, Stages...,
+            details::LazyStage<details::LazyStep::AndThen, std::decay_t<F>, E>>
+    and_then(F && fn) && {
+        return append<T2, E, details::LazyStep::AndThen, E>(
+                std::forward<F>(fn));
+    }
+
     template <typename F,
             typename E2 = typename std::invoke_result_t<F, E>::error_type,
             std::enable_if_t<std::is_invocable_r<Result<T, E2>, F, E>::value,
                     int> = 0>
-    Result<T, E2> or_else(F && fn) {
-        if(is_err()) {
-            return fn(std::move(*this).err_unchecked());
+    constexpr LazyResult<T0, E0, T, E2, Stages...,
+            details::LazyStage<details::LazyStep::OrElse, std::decay_t<F>>>
+    or_else(F && fn) && {
+        return append<T, E2, details::LazyStep::OrElse>(std::forward<F>(fn));
+    }
+
+    /// Runs the pipeline, consuming the source `Result`.
+    constexpr Result<T, E> collect() && {
+        if(details::hint_ok<E0>(m_source->is_ok())) {
+            return run_ok<0>(std::move(*m_source).ok_unchecked());
         } else {
-            return Result<T, E2>(Ok(std::move(*this).ok_unchecked()));
+            return run_err<0>(std::move(*m_source).err_unchecked());
         }
     }
 
-    // }}}
+private:
+    template <typename, typename, typename, typename, typename...>
+    friend class LazyResult;
+    friend class Result<T0, E0>;
+
+    using StageList = std::tuple<Stages...>;
+
+    constexpr LazyResult(Result<T0, E0>* source, StageList&& stages)
+        : m_source(source), m_stages(std::move(stages)) {}
+
+    template <typename T2, typename E2, details::LazyStep Step,
+            typename Err = void, typename F>
+    constexpr auto append(F&& fn) {
+        using Stage = details::LazyStage<Step, std::decay_t<F>, Err>;
+        return LazyResult<T0, E0, T2, E2, Stages..., Stage>(m_source,
+                std::tuple_cat(std::move(m_stages),
+                        std::tuple<Stage>(Stage{std::forward<F>(fn)})));
+    }
+
+    template <std::size_t I, typename X>
+    constexpr Result<T, E> run_ok(X&& value) {
+        if constexpr(I == sizeof...(Stages)) {
+            return Result<T, E>(ok_tag, std::forward<X>(value));
+        } else {
+            using Stage = std::tuple_element_t<I, StageList>;
+            auto& fn = std::get<I>(m_stages).fn;
+            if constexpr(Stage::step == details::LazyStep::Map) {
+                return run_ok<I + 1>(std::move(fn)(std::forward<X>(value)));
+            } else if constexpr(Stage::step == details::LazyStep::AndThen) {
+                auto next = std::move(fn)(std::forward<X>(value));
+                using Next = decltype(next);
+                if(details::hint_ok<typename Next::error_type>(next.is_ok())) {
+                    return run_ok<I + 1>(std::move(next).ok_unchecked());
+                } else {
+                    return run_err<I + 1>(
+                            details::as_error<typename Stage::error_type>(
+                                    std::move(next).err_unchecked()));
+                }
+            } else {
+                return run_ok<I + 1>(std::forward<X>(value));
+            }
+        }
+    }
+
+    template <std::size_t I, typename X>
+    constexpr Result<T, E> run_err(X&& error) {
+        if constexpr(I == sizeof...(Stages)) {
+            return Result<T, E>(err_tag, std::forward<X>(error));
+        } else {
+            using Stage = std::tuple_element_t<I, StageList>;
+            auto& fn = std::get<I>(m_stages).fn;
+            if constexpr(Stage::step == details::LazyStep::MapErr) {
+                return run_err<I + 1>(std::move(fn)(std::forward<X>(error)));
+            } else if constexpr(Stage::step == details::LazyStep::OrElse) {
+                auto next = std::move(fn)(std::forward<X>(error));
+                using Next = decltype(next);
+                if(details::hint_ok<typename Next::error_type>(next.is_ok())) {
+                    return run_ok<I + 1>(std::move(next).ok_unchecked());
+                } else {
+                    return run_err<I + 1>(std::move(next).err_unchecked());
+                }
+            } else {
+                return run_err<I + 1>(std::forward<X>(error));
+            }
+        }
+    }
+
+    Result<T0, E0>* m_source;
+    StageList m_stages;
+};
+
+/// A `Result` stored without alignment padding, for large arrays of results.
+///
+/// The contents are kept as raw bytes, so a `PackedResult` has an alignment of
+/// one and a size of `max(sizeof(T), sizeof(E)) + 1`, or `sizeof(Result<T, E>)`
+/// when the `Result` needs no tag. Values are copied in and out as whole
+/// `Result` objects, so both `T` and `E` must be trivially copyable.
+template <typename T, typename E>
+class PackedResult {
+    static constexpr bool has_tag =
+            details::storage_layout<T, E> == details::StorageLayout::TagAfter ||
+            details::storage_layout<T, E> ==
+                    details::StorageLayout::TagInPadding;
+    static constexpr std::size_t payload_size =
+            details::tagged_layout<T, E>::payload_size;
+
+public:
+    using value_type = T;
+    using error_type = E;
+
+    static_assert(std::is_trivially_copyable<T>::value &&
+                    std::is_trivially_copyable<E>::value,
+            "PackedResult<T, E> requires trivially copyable T and E");
+
+    PackedResult(const Result<T, E>& result) noexcept { store(result); }
+    PackedResult(Ok<T> value) noexcept { store(Result<T, E>(std::move(value))); }
+    PackedResult(Err<E> value) noexcept {
+        store(Result<T, E>(std::move(value)));
+    }
+
+    ResultKind kind() const noexcept {
+        if constexpr(has_tag) {
+            return static_cast<ResultKind>(m_bytes[payload_size]);
+        } else {
+            return load().kind();
+        }
+    }
+    bool is_ok() const noexcept { return kind() == ResultKind::Ok; }
+    bool is_err() const noexcept { return kind() == ResultKind::Err; }
+
+    Result<T, E> load() const noexcept {
+        if constexpr(has_tag) {
+            if(is_ok()) {
+                return Result<T, E>(ok_tag, read<T>());
+            } else {
+                return Result<T, E>(err_tag, read<E>());
+            }
+        } else {
+            return read<Result<T, E>>();
+        }
+    }
+    void store(const Result<T, E>& result) noexcept {
+        if constexpr(has_tag) {
+            if(result.is_ok()) {
+                std::memcpy(m_bytes, &result.ok_unchecked(), sizeof(T));
+            } else {
+                std::memcpy(m_bytes, &result.err_unchecked(), sizeof(E));
+            }
+            m_bytes[payload_size] = static_cast<unsigned char>(result.kind());
+        } else {
+            std::memcpy(m_bytes, &result, sizeof(result));
+        }
+    }
+
+    operator Result<T, E>() const noexcept { return load(); }
 
 private:
-    details::ResultStorage<T, E> m_storage;
+    template <typename U>
+    U read() const noexcept {
+        std::aligned_storage_t<sizeof(U), alignof(U)> value;
+        std::memcpy(&value, m_bytes, sizeof(U));
+        return *reinterpret_cast<const U*>(&value);
+    }
+
+    unsigned char m_bytes[has_tag ? payload_size + 1 : sizeof(Result<T, E>)];
 };
 
+// Results order like their Ok values, with every Err before every Ok. Errors
+// are equivalent to each other.
 template <typename T, typename T2, typename E>
 inline constexpr bool operator<(
         const Result<T, E>& lhs, const Result<T2, E>& rhs) {
-    if(lhs.is_err() && rhs.is_err()) {
-        return false;
+    if(lhs.is_ok() && rhs.is_ok()) {
+        return lhs.ok_unchecked() < rhs.ok_unchecked();
     }
-    if(lhs.is_err()) {
-        return true;
-    }
-    return lhs.try_ok() < rhs.try_ok();
+    return lhs.is_err() && rhs.is_ok();
 }
 template <typename T, typename T2, typename E>
 inline constexpr bool operator<=(
         const Result<T, E>& lhs, const Result<T2, E>& rhs) {
-    if(lhs.is_err() && rhs.is_err()) {
-        return true;
-    }
-    if(lhs.is_err()) {
-        return true;
+    if(lhs.is_ok() && rhs.is_ok()) {
+        return lhs.ok_unchecked() <= rhs.ok_unchecked();
     }
-    return lhs.try_ok() <= rhs.try_ok();
+    return lhs.is_err();
 }
 template <typename T, typename T2, typename E>
 inline constexpr bool operator>(
@@ -590,87 +1975,36 @@ inline constexpr bool operator>=(
 }
 
 template <typename T, typename T2, typename E>
-inline constexpr bool operator<(const Result<T, E>& lhs, Ok<T2> rhs) {
-    return lhs < Result<T2, E>(std::move(rhs));
+inline constexpr bool operator<(const Result<T, E>& lhs, const Ok<T2>& rhs) {
+    return lhs.is_err() || lhs.ok_unchecked() < rhs.value();
 }
 template <typename T, typename T2, typename E>
-inline constexpr bool operator<=(const Result<T, E>& lhs, Ok<T2> rhs) {
-    return lhs <= Result<T2, E>(std::move(rhs));
+inline constexpr bool operator<=(const Result<T, E>& lhs, const Ok<T2>& rhs) {
+    return lhs.is_err() || lhs.ok_unchecked() <= rhs.value();
 }
 template <typename T, typename T2, typename E>
-inline constexpr bool operator>(const Result<T, E>& lhs, Ok<T2> rhs) {
-    return lhs > Result<T2, E>(std::move(rhs));
+inline constexpr bool operator>(const Result<T, E>& lhs, const Ok<T2>& rhs) {
+    return !(lhs <= rhs);
 }
 template <typename T, typename T2, typename E>
-inline constexpr bool operator>=(const Result<T, E>& lhs, Ok<T2> rhs) {
-    return lhs >= Result<T2, E>(std::move(rhs));
-}
-template <typename T, typename E>
-inline constexpr bool operator<(const Result<T, E>& lhs, Err<E> rhs) {
-    return lhs < Result<T, E>(std::move(rhs));
+inline constexpr bool operator>=(const Result<T, E>& lhs, const Ok<T2>& rhs) {
+    return !(lhs < rhs);
 }
 template <typename T, typename E>
-inline constexpr bool operator<=(const Result<T, E>& lhs, Err<E> rhs) {
-    return lhs <= Result<T, E>(std::move(rhs));
+inline constexpr bool operator<(const Result<T, E>&, const Err<E>&) {
+    return false;
 }
 template <typename T, typename E>
-inline constexpr bool operator>(const Result<T, E>& lhs, Err<E> rhs) {
-    return lhs > Result<T, E>(std::move(rhs));
+inline constexpr bool operator<=(const Result<T, E>& lhs, const Err<E>&) {
+    return lhs.is_err();
 }
 template <typename T, typename E>
-inline constexpr bool operator>=(const Result<T, E>& lhs, Err<E> rhs) {
-    return lhs >= Result<T, E>(std::move(rhs));
-}
-
-template <typename T>
-inline std::ostream& operator<<(std::ostream& stream, unit_t) {
-    stream << "()";
-    return stream;
-}
-
-template <typename T>
-inline std::ostream& operator<<(std::ostream& stream, const Ok<T>& ok) {
-    if constexpr(std::is_same<T, unit_t>::value) {
-        stream << "Ok()" << std::endl;
-    } else {
-        stream << "Ok(" << ok.value() << ")";
-    }
-    return stream;
-}
-template <typename T>
-inline std::ostream& operator<<(std::ostream& stream, const Err<T>& err) {
-    stream << "Err(" << err.value() << ")";
-    return stream;
+inline constexpr bool operator>(const Result<T, E>& lhs, const Err<E>&) {
+    return lhs.is_ok();
 }
-
 template <typename T, typename E>
-inline std::ostream& operator<<(
-        std::ostream& stream, const Result<T, E>& result) {
-    switch(result.kind()) {
-    case ResultKind::Ok: {
-        if constexpr(std::is_same<T, unit_t>::value) {
-            stream << "Ok()";
-        } else {
-            stream << "Ok(" << result.ok().value() << ")";
-        }
-        break;
-    }
-    case ResultKind::Err: {
-        stream << "Err( " << result.err().value() << ")";
-        break;
-    }
-    default:
-        stream << "INVALID RESULT";
-        break;
-    }
-    return stream;
-}
-
-template <typename T>
-inline std::ostream& operator<<(
-        std::ostream& stream, const std::reference_wrapper<T>& obj) {
-    stream << obj.get();
-    return stream;
+inline constexpr bool operator>=(const Result<T, E>&, const Err<E>&) {
+    return true;
 }
 
 } // namespace result
@@ -688,6 +2022,107 @@ struct hash<result::Result<T, E>> {
 };
 } // namespace std
 
+namespace result {
+namespace details {
+
+// The error of a failed `RESULT_TRY`, held by reference until it converts to
+// the `Result` type the enclosing function returns. The error is moved (or,
+// from an lvalue `Result`, copied) straight into that `Result`, whatever its
+// value type, as long as its error type is constructible from `E`.
+template <typename Ref>
+class PropagatedErr {
+public:
+    explicit constexpr PropagatedErr(Ref error) noexcept
+        : m_error(std::forward<Ref>(error)) {}
+
+    template <typename T2, typename E2,
+            std::enable_if_t<
+                    error_converts<std::remove_cv_t<
+                                           std::remove_reference_t<Ref>>,
+                            E2>,
+                    int> = 0>
+    constexpr operator Result<T2, E2>() && {
+        return Result<T2, E2>(
+                err_tag, convert_err<E2>(std::forward<Ref>(m_error)));
+    }
+
+private:
+    Ref m_error;
+};
+
+template <typename T, typename E>
+constexpr bool try_failed(const Result<T, E>& result) noexcept {
+    return hint_err<E>(result.is_err());
+}
+
+template <typename R>
+constexpr auto propagate_err(R&& result) noexcept {
+    using Ref = decltype(std::forward<R>(result).err_unchecked());
+    return PropagatedErr<Ref>(std::forward<R>(result).err_unchecked());
+}
+
+} // namespace details
+} // namespace result
+
+/// Evaluates `expr`, which must yield a `Result`. On `Ok` the whole
+/// expression evaluates to the value; on `Err` the enclosing function returns
+/// the error, converted to the error type of the `Result` it returns.
+///
+///     Result<Config, ConfigError> load(const char* path) {
+///         std::string text = RESULT_TRY(read_file(path));
+///         return parse_config(text);
+///     }
+///
+/// An rvalue `Result` is moved from; an lvalue one is copied from and left
+/// unchanged. Yielding a value needs GCC/Clang statement expressions. Where
+/// they are unavailable `RESULT_TRY` is a statement that discards the value;
+/// use `RESULT_TRY_ASSIGN` to bind it portably.
+#if defined(__GNUC__) || defined(__clang__)
+#define RESULT_HAS_STATEMENT_EXPRESSIONS 1
+#define RESULT_TRY(expr)                                                       \
+    __extension__({                                                            \
+        auto&& result_try_ = (expr);                                           \
+        if(::result::details::try_failed(result_try_)) {                       \
+            return ::result::details::propagate_err(                           \
+                    std::forward<decltype(result_try_)>(result_try_));         \
+        }                                                                      \
+        std::forward<decltype(result_try_)>(result_try_).ok_unchecked();       \
+    })
+#else
+#define RESULT_TRY(expr)                                                       \
+    do {                                                                       \
+        auto&& result_try_ = (expr);                                           \
+        if(::result::details::try_failed(result_try_)) {                       \
+            return ::result::details::propagate_err(                           \
+                    std::forward<decltype(result_try_)>(result_try_));         \
+        }                                                                      \
+    } while(false)
+#endif
+
+#define RESULT_TRY_CONCAT_(a, b) a##b
+#define RESULT_TRY_NAME_(id) RESULT_TRY_CONCAT_(result_try_assign_, id)
+
+/// Portable form of `RESULT_TRY` that assigns the `Ok` value to `lhs`, which
+/// may be a declaration:
+///
+///     RESULT_TRY_ASSIGN(std::string text, read_file(path));
+///
+/// It expands to several statements so that a declared `lhs` stays in scope,
+/// and so must be used as a statement of its own: put it in braces under an
+/// `if` or `else`.
+#define RESULT_TRY_ASSIGN(lhs, expr)                                           \
+    RESULT_TRY_ASSIGN_IMPL_(RESULT_TRY_NAME_(__COUNTER__), lhs, expr)
+#define RESULT_TRY_ASSIGN_IMPL_(name, lhs, expr)                               \
+    auto&& name = (expr);                                                      \
+    if(::result::details::try_failed(name)) {                                  \
+        return ::result::details::propagate_err(                               \
+                std::forward<decltype(name)>(name));                           \
+    }                                                                          \
+    lhs = std::forward<decltype(name)>(name).ok_unchecked()
+
+/// Returns `res`, an lvalue `Result`, from the enclosing function if it holds
+/// an error. The function must return the same `Result` type, and the whole
+/// `Result` is copied; prefer `RESULT_TRY`.
 #define PROPAGATE(res)                                                         \
     {                                                                          \
         auto& r = res;                                                         \
@@ -696,4 +2131,8 @@ struct hash<result::Result<T, E>> {
         }                                                                      \
     }
 
+#if defined(RESULT_EXTERN_TEMPLATES)
+#include "result/extern.h"
+#endif
+
 #endif
@@ -0,0 +1,239 @@
+#ifndef RESULT_VECTOR_H_0c9b5e27_d84f_4a13_b6e2_71f3a95d0c8e
+#define RESULT_VECTOR_H_0c9b5e27_d84f_4a13_b6e2_71f3a95d0c8e
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "result/result.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace result {
+
+namespace details {
+
+inline unsigned popcount64(std::uint64_t word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcountll(word));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<unsigned>(__popcnt64(word));
+#else
+    unsigned count = 0;
+    for(; word != 0; word &= word - 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+} // namespace details
+
+/// A sequence of `Result<T, E>` stored as a structure of arrays: a bitmap of
+/// which elements are `Ok`, the `Ok` values packed together in order, and the
+/// errors packed together in a separate table.
+///
+/// A `std::vector<Result<T, E>>` interleaves tags, padding and room for the
+/// larger of `T` and `E` in every element. Here a scan over the successes
+/// reads `values()`, a plain array of `T`, and the errors cost nothing until
+/// they are asked for. The position of element `i` in either array is found
+/// in constant time from a count of `Ok` elements kept for every 64 elements.
+///
+/// Elements are added at the end only. Indexing and iteration yield
+/// `Result`s of `std::reference_wrapper`s into the arrays.
+template <typename T, typename E>
+class ResultVector {
+    static_assert(!std::is_same<T, bool>::value &&
+                    !std::is_same<E, bool>::value,
+            "ResultVector hands out references into std::vector<T> and "
+            "std::vector<E>, which std::vector<bool> cannot give; use char "
+            "instead of bool");
+
+public:
+    using value_type = Result<T, E>;
+    using reference = Result<std::reference_wrapper<T>,
+            std::reference_wrapper<E>>;
+    using const_reference = Result<std::reference_wrapper<const T>,
+            std::reference_wrapper<const E>>;
+    using size_type = std::size_t;
+
+    class const_iterator;
+
+    ResultVector() = default;
+
+    size_type size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+    size_type ok_count() const noexcept { return m_values.size(); }
+    size_type err_count() const noexcept { return m_errors.size(); }
+
+    /// Reserves room for `count` elements, assuming they are all `Ok`.
+    void reserve(size_type count) {
+        m_values.reserve(count);
+        m_ok_bits.reserve(words_for(count));
+        m_ok_before.reserve(words_for(count));
+    }
+    void clear() noexcept {
+        m_ok_bits.clear();
+        m_ok_before.clear();
+        m_values.clear();
+        m_errors.clear();
+        m_size = 0;
+    }
+
+    void push_back(const Result<T, E>& result) {
+        if(details::hint_ok<E>(result.is_ok())) {
+            emplace_ok(result.ok_unchecked());
+        } else {
+            emplace_err(result.err_unchecked());
+        }
+    }
+    void push_back(Result<T, E>&& result) {
+        if(details::hint_ok<E>(result.is_ok())) {
+            emplace_ok(std::move(result).ok_unchecked());
+        } else {
+            emplace_err(std::move(result).err_unchecked());
+        }
+    }
+
+    /// Appends an `Ok` constructed in place from `args`.
+    template <typename... Args>
+    T& emplace_ok(Args&&... args) {
+        start_word();
+        T& value = m_values.emplace_back(std::forward<Args>(args)...);
+        m_ok_bits.back() |= std::uint64_t(1) << (m_size % 64);
+        ++m_size;
+        return value;
+    }
+    /// Appends an `Err` constructed in place from `args`.
+    template <typename... Args>
+    E& emplace_err(Args&&... args) {
+        start_word();
+        E& error = m_errors.emplace_back(std::forward<Args>(args)...);
+        ++m_size;
+        return error;
+    }
+
+    bool is_ok(size_type index) const noexcept {
+        return (m_ok_bits[index / 64] >> (index % 64)) & 1;
+    }
+    bool is_err(size_type index) const noexcept { return !is_ok(index); }
+
+    const_reference operator[](size_type index) const {
+        size_type oks = ok_rank(index);
+        if(is_ok(index)) {
+            return const_reference(ok_tag, std::cref(m_values[oks]));
+        }
+        return const_reference(err_tag, std::cref(m_errors[index - oks]));
+    }
+    reference operator[](size_type index) {
+        size_type oks = ok_rank(index);
+        if(is_ok(index)) {
+            return reference(ok_tag, std::ref(m_values[oks]));
+        }
+        return reference(err_tag, std::ref(m_errors[index - oks]));
+    }
+
+    /// The `Ok` values, in order.
+    const std::vector<T>& values() const noexcept { return m_values; }
+    /// The errors, in order.
+    const std::vector<E>& errors() const noexcept { return m_errors; }
+
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, m_size); }
+
+private:
+    static size_type words_for(size_type count) noexcept {
+        return (count + 63) / 64;
+    }
+
+    // Opens a new word of the bitmap when the next element needs one. A word
+    // left over by an append that threw is reused. The rank table and the
+    // bitmap always grow together: if the second push throws, the first is
+    // undone.
+    void start_word() {
+        if(m_ok_bits.size() * 64 == m_size) {
+            m_ok_before.push_back(m_values.size());
+            try {
+                m_ok_bits.push_back(0);
+            } catch(...) {
+                m_ok_before.pop_back();
+                throw;
+            }
+        }
+    }
+
+    // The number of `Ok` elements before `index`.
+    size_type ok_rank(size_type index) const noexcept {
+        std::uint64_t below = (std::uint64_t(1) << (index % 64)) - 1;
+        return m_ok_before[index / 64] +
+                details::popcount64(m_ok_bits[index / 64] & below);
+    }
+
+    std::vector<std::uint64_t> m_ok_bits;
+    std::vector<size_type> m_ok_before;
+    std::vector<T> m_values;
+    std::vector<E> m_errors;
+    size_type m_size = 0;
+};
+
+/// Visits the elements of a `ResultVector` in order. Keeps running positions
+/// in both arrays, so advancing only reads one bit of the bitmap.
+template <typename T, typename E>
+class ResultVector<T, E>::const_iterator {
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = const_reference;
+    using reference = const_reference;
+    using pointer = void;
+    using difference_type = std::ptrdiff_t;
+
+    const_iterator() = default;
+
+    reference operator*() const {
+        if(m_vector->is_ok(m_index)) {
+            return reference(ok_tag, std::cref(m_vector->m_values[m_oks]));
+        }
+        return reference(err_tag,
+                std::cref(m_vector->m_errors[m_index - m_oks]));
+    }
+
+    const_iterator& operator++() noexcept {
+        m_oks += m_vector->is_ok(m_index);
+        ++m_index;
+        return *this;
+    }
+    const_iterator operator++(int) noexcept {
+        const_iterator old = *this;
+        ++*this;
+        return old;
+    }
+
+    bool operator==(const const_iterator& other) const noexcept {
+        return m_index == other.m_index;
+    }
+    bool operator!=(const const_iterator& other) const noexcept {
+        return m_index != other.m_index;
+    }
+
+private:
+    friend class ResultVector<T, E>;
+
+    const_iterator(const ResultVector* vector, size_type index) noexcept
+        : m_vector(vector),
+          m_index(index),
+          m_oks(index == 0 ? 0 : vector->m_values.size()) {}
+
+    const ResultVector* m_vector = nullptr;
+    size_type m_index = 0;
+    size_type m_oks = 0;
+};
+
+} // namespace result
+
+#endif
@@ -0,0 +1,130 @@
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <catch/catch.hpp>
+
+#include "result/batch.h"
+#include "result/io.h"
+#include "result/result.h"
+
+using namespace result;
+
+namespace {
+
+// Deterministic inputs with runs of all-Ok and all-Err words as well as mixed
+// ones. Values are small integers so that sums are exact in any order.
+std::vector<Result<double, unit_t>> make_results(std::size_t count) {
+    std::vector<Result<double, unit_t>> results;
+    std::uint32_t state = 12345;
+    for(std::size_t i = 0; i < count; ++i) {
+        state = state * 1103515245 + 12345;
+        bool ok = (i / 64) % 4 == 0 || ((i / 64) % 4 != 1 && state % 3 != 0);
+        if(ok) {
+            results.emplace_back(ok_tag, double(state % 1000) - 500.0);
+        } else {
+            results.emplace_back(err_tag);
+        }
+    }
+    return results;
+}
+
+struct Expected {
+    std::size_t oks = 0;
+    std::size_t first_err;
+    double sum = 0;
+    std::optional<double> min;
+    std::optional<double> max;
+};
+
+Expected expected(const std::vector<Result<double, unit_t>>& results) {
+    Expected e;
+    e.first_err = results.size();
+    for(std::size_t i = 0; i < results.size(); ++i) {
+        if(results[i].is_err()) {
+            e.first_err = std::min(e.first_err, i);
+            continue;
+        }
+        double x = results[i].ok_unchecked();
+        ++e.oks;
+        e.sum += x;
+        e.min = e.min ? std::min(*e.min, x) : x;
+        e.max = e.max ? std::max(*e.max, x) : x;
+    }
+    return e;
+}
+
+} // namespace
+
+TEST_CASE("ResultBatch kernels agree at every SIMD level", "[batch]") {
+    const SimdLevel best = simd_level();
+    for(SimdLevel level :
+            {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2}) {
+        set_simd_level(level);
+        for(std::size_t count : {0, 1, 63, 64, 65, 200, 1000, 4099}) {
+            auto results = make_results(count);
+            ResultBatch<double> batch;
+            for(const auto& result : results) {
+                batch.push_back(result);
+            }
+            Expected e = expected(results);
+
+            REQUIRE(batch.size() == count);
+            REQUIRE(batch.count_ok() == e.oks);
+            REQUIRE(batch.find_first_err() == e.first_err);
+            REQUIRE(batch.sum_ok() == e.sum);
+            REQUIRE(batch.min_ok() == e.min);
+            REQUIRE(batch.max_ok() == e.max);
+
+            batch.map_ok([](double x) { return x * 2.0 + 1.0; });
+            for(std::size_t i = 0; i < count; ++i) {
+                REQUIRE(batch.is_ok(i) == results[i].is_ok());
+                if(results[i].is_ok()) {
+                    REQUIRE(batch[i].unwrap() ==
+                            results[i].unwrap() * 2.0 + 1.0);
+                }
+            }
+        }
+    }
+    set_simd_level(best);
+    REQUIRE(simd_level() == best);
+}
+
+TEST_CASE("ResultBatch", "[batch]") {
+    SECTION("find_first_err skips full words") {
+        ResultBatch<int> batch;
+        for(int i = 0; i < 300; ++i) {
+            batch.push_ok(i);
+        }
+        REQUIRE(batch.find_first_err() == 300);
+        batch.push_err();
+        REQUIRE(batch.find_first_err() == 300);
+        REQUIRE(batch[300].is_err());
+    }
+    SECTION("Integer reductions") {
+        ResultBatch<std::int64_t> batch;
+        batch.push_ok(5);
+        batch.push_err();
+        batch.push_ok(-3);
+        REQUIRE(batch.sum_ok() == 2);
+        REQUIRE(batch.min_ok() == -3);
+        REQUIRE(batch.max_ok() == 5);
+    }
+    SECTION("No Ok elements") {
+        ResultBatch<double> batch;
+        batch.push_err();
+        REQUIRE(batch.count_ok() == 0);
+        REQUIRE(batch.sum_ok() == 0.0);
+        REQUIRE(!batch.min_ok());
+        REQUIRE(!batch.max_ok());
+    }
+    SECTION("clear") {
+        ResultBatch<double> batch;
+        batch.push_err();
+        batch.clear();
+        batch.push_ok(1.5);
+        REQUIRE(batch.size() == 1);
+        REQUIRE(batch.find_first_err() == 1);
+        REQUIRE(batch[0].unwrap() == 1.5);
+    }
+}
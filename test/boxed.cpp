@@ -0,0 +1,115 @@
+#include <string>
+#include <vector>
+
+#include <catch/catch.hpp>
+
+#include "result/boxed.h"
+#include "result/io.h"
+#include "result/result.h"
+
+using namespace result;
+using namespace std::literals::string_literals;
+
+namespace {
+
+struct MyError {
+    enum class ErrorKind { OutOfDomain, Overflow };
+
+    MyError(ErrorKind kind, std::string reason = "")
+        : kind(kind), reason(std::move(reason)) {}
+
+    bool operator==(const MyError& other) const {
+        return kind == other.kind && reason == other.reason;
+    }
+
+    ErrorKind kind;
+    std::string reason;
+};
+
+static_assert(sizeof(Result<int, Boxed<MyError>>) ==
+        sizeof(Result<int, void*>));
+static_assert(sizeof(Result<int, Boxed<MyError>>) <
+        sizeof(Result<int, MyError>));
+static_assert(sizeof(Status<Boxed<MyError>>) == sizeof(void*));
+
+} // namespace
+
+TEST_CASE("Boxed errors", "[boxed]") {
+    SECTION("Construction and access") {
+        auto result1 = Result<int, Boxed<MyError>>(Ok(5));
+        auto result2 = Result<int, Boxed<MyError>>(Err(Boxed<MyError>(
+                MyError(MyError::ErrorKind::OutOfDomain, "out of domain"s))));
+
+        REQUIRE(result1.unwrap() == 5);
+        REQUIRE(result2.is_err());
+        REQUIRE(result2.try_err()->kind == MyError::ErrorKind::OutOfDomain);
+        REQUIRE(result2.try_err()->reason == "out of domain"s);
+    }
+    SECTION("Copy and assignment") {
+        auto result1 = Result<int, Boxed<MyError>>(err_tag,
+                std::in_place,
+                MyError::ErrorKind::Overflow,
+                "overflow"s);
+        auto result2 = result1;
+
+        REQUIRE((result1 == result2));
+        REQUIRE(&*result1.try_err() != &*result2.try_err());
+
+        result2 = Result<int, Boxed<MyError>>(Ok(10));
+        REQUIRE((result2 == Ok(10)));
+        result2 = result1;
+        REQUIRE(result2.try_err()->reason == "overflow"s);
+    }
+    SECTION("Blocks are reused") {
+        const MyError* first = nullptr;
+        {
+            Boxed<MyError> error(MyError(MyError::ErrorKind::Overflow));
+            first = &*error;
+        }
+        Boxed<MyError> error(MyError(MyError::ErrorKind::OutOfDomain));
+        REQUIRE(&*error == first);
+    }
+    SECTION("Status") {
+        auto ok = Status<Boxed<MyError>>(Ok());
+        auto err = Status<Boxed<MyError>>(
+                Err(Boxed<MyError>(MyError(MyError::ErrorKind::Overflow))));
+
+        REQUIRE(ok.is_ok());
+        REQUIRE(err.is_err());
+        REQUIRE(err.try_err()->kind == MyError::ErrorKind::Overflow);
+    }
+    SECTION("Copying a Status") {
+        // The Ok state is a null Boxed, which copies as null.
+        auto ok = Status<Boxed<MyError>>(Ok());
+        auto copy = ok;
+        REQUIRE(copy.is_ok());
+
+        auto err = Status<Boxed<MyError>>(
+                Err(Boxed<MyError>(MyError(MyError::ErrorKind::Overflow))));
+        copy = err;
+        REQUIRE(copy.try_err()->kind == MyError::ErrorKind::Overflow);
+        copy = ok;
+        REQUIRE(copy.is_ok());
+    }
+    SECTION("Copying a moved-from Boxed") {
+        Boxed<MyError> error(MyError(MyError::ErrorKind::Overflow));
+        Boxed<MyError> taken = std::move(error);
+        Boxed<MyError> copy = error;
+        REQUIRE(copy.operator->() == nullptr);
+
+        copy = taken;
+        REQUIRE(copy->kind == MyError::ErrorKind::Overflow);
+        copy = error;
+        REQUIRE(copy.operator->() == nullptr);
+    }
+    SECTION("Comparing a moved-from Boxed") {
+        Boxed<MyError> error(MyError(MyError::ErrorKind::Overflow));
+        Boxed<MyError> taken = std::move(error);
+        Boxed<MyError> empty = std::move(error);
+        Boxed<MyError> same(MyError(MyError::ErrorKind::Overflow));
+        REQUIRE(error == empty);
+        REQUIRE(error != taken);
+        REQUIRE(taken != error);
+        REQUIRE(taken == same);
+    }
+}
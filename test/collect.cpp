@@ -0,0 +1,130 @@
+#include <list>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <catch/catch.hpp>
+
+#include "result/collect.h"
+#include "result/io.h"
+#include "result/result.h"
+
+#include "counted.h"
+
+using namespace result;
+
+namespace {
+
+using R = Result<int, std::string>;
+
+R parse(const std::string& text) {
+    if(text.empty() || text[0] < '0' || text[0] > '9') {
+        return R(err_tag, "bad: " + text);
+    }
+    return R(ok_tag, text[0] - '0');
+}
+
+} // namespace
+
+TEST_CASE("collect", "[collect]") {
+    SECTION("All Ok") {
+        std::vector<R> results{R(ok_tag, 1), R(ok_tag, 2), R(ok_tag, 3)};
+        auto all = collect(results);
+        REQUIRE(all.unwrap() == std::vector<int>{1, 2, 3});
+        // The size of a random access range is known up front.
+        REQUIRE(all.unwrap().capacity() == 3);
+    }
+    SECTION("Stops at the first Err") {
+        std::vector<R> results{
+                R(ok_tag, 1), R(err_tag, "first"), R(err_tag, "second")};
+        REQUIRE(collect(results).unwrap_err() == "first");
+        REQUIRE(collect(results.begin(), results.begin() + 1).unwrap() ==
+                std::vector<int>{1});
+    }
+    SECTION("Empty range") {
+        std::vector<R> results;
+        REQUIRE(collect(results).unwrap().empty());
+    }
+    SECTION("Other containers and ranges") {
+        std::list<R> results{R(ok_tag, 3), R(ok_tag, 1), R(ok_tag, 3)};
+        REQUIRE(collect<std::set<int>>(results).unwrap() ==
+                std::set<int>{1, 3});
+        R array[] = {R(ok_tag, 4), R(ok_tag, 5)};
+        REQUIRE(collect(array).unwrap() == std::vector<int>{4, 5});
+    }
+    SECTION("Rvalue ranges are moved from, lvalue ranges copied") {
+        using C = Result<Counted, Counted>;
+        std::vector<C> results;
+        results.emplace_back(ok_tag, 1);
+        results.emplace_back(ok_tag, 2);
+
+        Counted::reset();
+        auto copied = collect(results);
+        REQUIRE(Counted::counts.copies == 2);
+        REQUIRE(Counted::counts.moves == 0);
+
+        Counted::reset();
+        auto moved = collect(std::move(results));
+        REQUIRE(Counted::counts.copies == 0);
+        REQUIRE(Counted::counts.moves == 2);
+        REQUIRE(moved.unwrap()[1].value == 2);
+    }
+}
+
+TEST_CASE("try_collect", "[collect]") {
+    std::vector<std::string> texts{"1", "2", "x", "y"};
+    int calls = 0;
+    auto counted_parse = [&](const std::string& text) {
+        ++calls;
+        return parse(text);
+    };
+    REQUIRE(try_collect(texts, counted_parse).unwrap_err() == "bad: x");
+    REQUIRE(calls == 3);
+    REQUIRE(try_collect(texts.begin(), texts.begin() + 2, parse).unwrap() ==
+            std::vector<int>{1, 2});
+}
+
+TEST_CASE("partition", "[collect]") {
+    std::vector<R> results{R(ok_tag, 1), R(err_tag, "a"), R(ok_tag, 2),
+            R(err_tag, "b")};
+    auto [values, errors] = partition(results);
+    REQUIRE(values == std::vector<int>{1, 2});
+    REQUIRE(errors == std::vector<std::string>{"a", "b"});
+
+    auto moved = partition(std::move(results));
+    REQUIRE(moved.second == std::vector<std::string>{"a", "b"});
+}
+
+TEST_CASE("try_for_each", "[collect]") {
+    std::vector<std::string> texts{"1", "2", "x", "y"};
+    std::vector<int> seen;
+    auto record = [&](const std::string& text) {
+        return parse(text).map([&](int x) {
+            seen.push_back(x);
+            return unit;
+        });
+    };
+    REQUIRE(try_for_each(texts, record) == Err(std::string("bad: x")));
+    REQUIRE(seen == std::vector<int>{1, 2});
+    REQUIRE(try_for_each(texts.begin(), texts.begin() + 2, record).is_ok());
+}
+
+TEST_CASE("try_fold", "[collect]") {
+    std::vector<std::string> texts{"1", "2", "3"};
+    auto add = [](int sum, const std::string& text) {
+        return parse(text).map([&](int x) { return sum + x; });
+    };
+    REQUIRE(try_fold(texts, 10, add) == Ok(16));
+    texts.push_back("x");
+    texts.push_back("y");
+    REQUIRE(try_fold(texts, 0, add) == Err(std::string("bad: x")));
+
+    std::vector<Counted> items(3);
+    Counted::reset();
+    auto take = [](Counted acc, Counted&& item) {
+        acc.value += item.value + 1;
+        return Result<Counted, std::string>(ok_tag, std::move(acc));
+    };
+    REQUIRE(try_fold(std::move(items), Counted(), take).unwrap().value == 3);
+    REQUIRE(Counted::counts.copies == 0);
+}
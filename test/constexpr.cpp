@@ -0,0 +1,127 @@
+#include <cstdint>
+
+#include <catch/catch.hpp>
+
+#include "result/io.h"
+#include "result/result.h"
+
+using namespace result;
+
+namespace {
+
+enum class ParseError : std::uint8_t { Empty, NotADigit, Overflow };
+
+constexpr Result<int, ParseError> parse_digit(char c) {
+    if(c < '0' || c > '9') {
+        return Result<int, ParseError>(Err(ParseError::NotADigit));
+    }
+    return Result<int, ParseError>(Ok(c - '0'));
+}
+
+constexpr Result<int, ParseError> parse_int(const char* str) {
+    if(*str == '\0') {
+        return Result<int, ParseError>(Err(ParseError::Empty));
+    }
+    int value = 0;
+    for(; *str != '\0'; ++str) {
+        auto digit = parse_digit(*str);
+        if(digit.is_err()) {
+            return digit;
+        }
+        if(value > 100000) {
+            return Result<int, ParseError>(Err(ParseError::Overflow));
+        }
+        value = value * 10 + digit.unwrap();
+    }
+    return Result<int, ParseError>(Ok(value));
+}
+
+constexpr int add_one(int x) { return x + 1; }
+constexpr Result<int, ParseError> halve(int x) {
+    if(x % 2 != 0) {
+        return Result<int, ParseError>(Err(ParseError::Overflow));
+    }
+    return Result<int, ParseError>(Ok(x / 2));
+}
+
+// Construction and queries
+static_assert(parse_digit('7').is_ok());
+static_assert(parse_digit('x').is_err());
+static_assert(parse_digit('7') == Ok(7));
+static_assert(parse_digit('x') == Err(ParseError::NotADigit));
+static_assert(parse_digit('3') != parse_digit('4'));
+static_assert(parse_int("1234") == Ok(1234));
+static_assert(parse_int("") == Err(ParseError::Empty));
+static_assert(parse_int("12a") == Err(ParseError::NotADigit));
+static_assert(Result<int, ParseError>(ok_tag, 5).unwrap() == 5);
+static_assert(Result<int, int>(err_tag, 5).unwrap_err() == 5);
+static_assert(Result<int, int>(ok_tag, 5).unwrap_unchecked() == 5);
+static_assert(Result<int, int>(err_tag, 5).unwrap_err_unchecked() == 5);
+static_assert(Result<int, int>(err_tag, 5).unwrap_or_default() == 0);
+static_assert(Result<int, int>(Ok(1)) < Result<int, int>(Ok(2)));
+
+// Accessors
+static_assert(parse_digit('7').unwrap_or(0) == 7);
+static_assert(parse_digit('x').unwrap_or(0) == 0);
+static_assert(parse_digit('x').unwrap_err_or(ParseError::Empty) ==
+        ParseError::NotADigit);
+static_assert(parse_digit('7').expect("digit") == 7);
+static_assert(parse_digit('7').ok_unchecked() == 7);
+
+// Combinators
+static_assert(parse_digit('7').map(add_one) == Ok(8));
+static_assert(parse_digit('x').map(add_one) == Err(ParseError::NotADigit));
+static_assert(parse_digit('8').and_then(halve) == Ok(4));
+static_assert(parse_digit('7').and_then(halve) == Err(ParseError::Overflow));
+static_assert(parse_digit('x').map_err([](ParseError) { return 1; }) ==
+        Err(1));
+static_assert(parse_digit('1').and_(parse_digit('2')) == Ok(2));
+static_assert(parse_digit('x').or_(parse_digit('2')) == Ok(2));
+static_assert(parse_digit('x').or_else([](ParseError) {
+    return Result<int, int>(Ok(0));
+}) == Ok(0));
+
+// Copies and assignment
+constexpr Result<int, ParseError> reassign() {
+    auto result = parse_digit('1');
+    auto other = parse_digit('x');
+    result = other;
+    return result;
+}
+static_assert(reassign() == Err(ParseError::NotADigit));
+
+// A lookup table computed with the same functions used at runtime.
+struct DigitTable {
+    int values[4];
+};
+constexpr DigitTable make_table() {
+    DigitTable table{};
+    const char input[] = "9x42";
+    for(int i = 0; i < 4; ++i) {
+        table.values[i] = parse_digit(input[i]).unwrap_or(-1);
+    }
+    return table;
+}
+constexpr DigitTable digit_table = make_table();
+static_assert(digit_table.values[0] == 9);
+static_assert(digit_table.values[1] == -1);
+static_assert(digit_table.values[3] == 2);
+
+// Results without a tag are constant expressions too.
+enum class Code : std::uint8_t { Success, Failure };
+} // namespace
+
+namespace result {
+template <>
+struct niche_traits<Code> : sentinel_niche<Code, Code::Success> {};
+} // namespace result
+
+namespace {
+static_assert(Status<Code>(Ok()).is_ok());
+static_assert(Status<Code>(Err(Code::Failure)).is_err());
+} // namespace
+
+TEST_CASE("Constant evaluation", "[constexpr]") {
+    REQUIRE(parse_int("42").unwrap() == 42);
+    REQUIRE(digit_table.values[2] == 4);
+}
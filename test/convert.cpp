@@ -0,0 +1,141 @@
+#include <string>
+#include <vector>
+
+#include <catch/catch.hpp>
+
+#include "result/io.h"
+#include "result/result.h"
+
+#include "counted.h"
+
+using namespace result;
+
+namespace {
+
+enum class IoError { NotFound, Denied };
+
+struct ServiceError {
+    enum Layer { Io, Parse } layer;
+    int code;
+};
+
+struct ParseError {
+    std::string what;
+};
+
+// Converts implicitly, so the default conversion applies.
+struct ConfigError {
+    ConfigError(ParseError error) : what("config: " + error.what) {}
+
+    std::string what;
+};
+
+// Records the moves of the error it was converted from.
+struct Wrapped {
+    Counted inner;
+};
+
+} // namespace
+
+template <>
+struct result::convert_error<IoError, ServiceError> {
+    static constexpr ServiceError convert(IoError&& error) {
+        return ServiceError{ServiceError::Io, static_cast<int>(error)};
+    }
+};
+
+template <>
+struct result::convert_error<Counted, Wrapped> {
+    static Wrapped convert(Counted&& error) {
+        return Wrapped{std::move(error)};
+    }
+};
+
+namespace {
+
+Result<std::string, IoError> read_file(const std::string& path) {
+    if(path.empty()) {
+        return Result<std::string, IoError>(err_tag, IoError::NotFound);
+    }
+    return Result<std::string, IoError>(ok_tag, "contents of " + path);
+}
+
+Result<std::size_t, ServiceError> file_size(const std::string& path) {
+    return Result<std::string, ServiceError>(read_file(path)).map(
+            [](const std::string& text) { return text.size(); });
+}
+
+#if defined(RESULT_HAS_STATEMENT_EXPRESSIONS)
+Result<std::size_t, ServiceError> file_size_try(const std::string& path) {
+    std::string text = RESULT_TRY(read_file(path));
+    return Result<std::size_t, ServiceError>(ok_tag, text.size());
+}
+#endif
+
+constexpr Result<long, long> widened = Result<int, int>(ok_tag, 3);
+static_assert(widened.is_ok() && widened.ok_unchecked() == 3);
+
+static_assert(std::is_convertible<Result<int, ParseError>,
+        Result<long, ConfigError>>::value);
+static_assert(std::is_convertible<Result<int, IoError>,
+        Result<int, ServiceError>>::value);
+// Only implicit conversions apply by default: an `int` does not become a
+// vector of that many elements.
+static_assert(!std::is_convertible<Result<int, int>,
+        Result<int, std::vector<int>>>::value);
+static_assert(!std::is_convertible<Result<int, ServiceError>,
+        Result<int, IoError>>::value);
+
+} // namespace
+
+TEST_CASE("Error conversion", "[convert]") {
+    SECTION("Implicit conversions are used by default") {
+        Result<long, ConfigError> ok = Result<int, ParseError>(ok_tag, 4);
+        REQUIRE(ok.unwrap() == 4);
+        Result<long, ConfigError> err =
+                Result<int, ParseError>(err_tag, ParseError{"x"});
+        REQUIRE(err.unwrap_err().what == "config: x");
+    }
+    SECTION("convert_error maps unrelated error types") {
+        REQUIRE(file_size("a").unwrap() == 13);
+        auto err = file_size("").unwrap_err();
+        REQUIRE(err.layer == ServiceError::Io);
+        REQUIRE(err.code == static_cast<int>(IoError::NotFound));
+    }
+#if defined(RESULT_HAS_STATEMENT_EXPRESSIONS)
+    SECTION("RESULT_TRY converts the error") {
+        REQUIRE(file_size_try("ab").unwrap() == 14);
+        REQUIRE(file_size_try("").unwrap_err().layer == ServiceError::Io);
+    }
+#endif
+    SECTION("and_then converts the error of the continuation") {
+        auto open = [](std::string path) { return read_file(path); };
+        using R = Result<std::string, ServiceError>;
+        REQUIRE(R(ok_tag, "a").and_then(open).unwrap() == "contents of a");
+        REQUIRE(R(ok_tag, "").and_then(open).unwrap_err().code ==
+                static_cast<int>(IoError::NotFound));
+        R empty(ok_tag, "");
+        REQUIRE(empty.lazy()
+                        .and_then(open)
+                        .map_err([](ServiceError e) { return e.code + 10; })
+                        .collect()
+                        .unwrap_err() ==
+                static_cast<int>(IoError::NotFound) + 10);
+    }
+    SECTION("The error is moved once, into the converted error") {
+        Result<int, Counted> source(err_tag, 5);
+        Counted::reset();
+        Result<int, Wrapped> converted = std::move(source);
+        REQUIRE(converted.err_unchecked().inner.value == 5);
+        REQUIRE(Counted::counts.moves == 1);
+        REQUIRE(Counted::counts.copies == 0);
+    }
+    SECTION("The value is moved once") {
+        Result<Counted, Counted> source(ok_tag, 5);
+        Counted::reset();
+        Result<Counted, Wrapped> converted = std::move(source);
+        REQUIRE(converted.ok_unchecked().value == 5);
+        REQUIRE(Counted::counts.moves == 1);
+        REQUIRE(Counted::counts.copies == 0);
+    }
+}
@@ -0,0 +1,129 @@
+#define CATCH_CONFIG_MAIN
+
+#include <string>
+
+#include <catch/catch.hpp>
+
+#include "result/coro.h"
+#include "result/result.h"
+
+#include "counted.h"
+
+using namespace result;
+using namespace std::literals::string_literals;
+
+namespace {
+
+struct ParseError {
+    std::string what;
+};
+struct ConfigError {
+    ConfigError(ParseError error) : what("config: " + error.what) {}
+
+    std::string what;
+};
+
+Result<int, ParseError> parse(const std::string& text) {
+    if(text.empty() || text[0] < '0' || text[0] > '9') {
+        return Result<int, ParseError>(err_tag, ParseError{text});
+    }
+    return Result<int, ParseError>(ok_tag, text[0] - '0');
+}
+
+Result<int, ParseError> add(std::string a, std::string b) {
+    int x = co_await parse(a);
+    int y = co_await parse(b);
+    co_return x + y;
+}
+
+// The error converts to the coroutine's error type.
+Result<std::string, ConfigError> describe(std::string text) {
+    int value = co_await parse(text);
+    co_return Ok(std::to_string(value));
+}
+
+Result<int, ParseError> reject_odd(std::string text) {
+    int value = co_await add(text, text);
+    if(value % 4 != 0) {
+        co_return Err(ParseError{"not a multiple of four"});
+    }
+    co_return value;
+}
+
+int destroyed_locals = 0;
+struct Local {
+    ~Local() { ++destroyed_locals; }
+};
+
+Result<int, ParseError> with_local(std::string text) {
+    Local local;
+    int value = co_await parse(text);
+    co_return value;
+}
+
+enum class IoError { NotFound };
+struct ServiceError {
+    int code;
+};
+
+} // namespace
+
+template <>
+struct result::convert_error<IoError, ServiceError> {
+    static ServiceError convert(IoError&& error) {
+        return ServiceError{100 + static_cast<int>(error)};
+    }
+};
+
+namespace {
+
+Result<int, ServiceError> lookup(bool found) {
+    using R = Result<int, IoError>;
+    int value = co_await(found ? R(ok_tag, 1) : R(err_tag, IoError::NotFound));
+    co_return value;
+}
+
+using C = Result<Counted, Counted>;
+
+Result<int, Counted> take(C result) {
+    Counted value = co_await std::move(result);
+    co_return value.value;
+}
+
+} // namespace
+
+TEST_CASE("Coroutines", "[coro]") {
+    SECTION("co_await yields the value") {
+        REQUIRE(add("1", "2").unwrap() == 3);
+        REQUIRE(describe("7").unwrap() == "7");
+        REQUIRE(reject_odd("2").unwrap() == 4);
+    }
+    SECTION("co_await returns the error") {
+        REQUIRE(add("x", "2").unwrap_err().what == "x");
+        REQUIRE(add("1", "y").unwrap_err().what == "y");
+        REQUIRE(describe("x").unwrap_err().what == "config: x");
+        REQUIRE(reject_odd("z").unwrap_err().what == "z");
+    }
+    SECTION("co_await applies convert_error") {
+        REQUIRE(lookup(true).unwrap() == 1);
+        REQUIRE(lookup(false).unwrap_err().code == 100);
+    }
+    SECTION("co_return takes Err") {
+        REQUIRE(reject_odd("1").unwrap_err().what == "not a multiple of four");
+    }
+    SECTION("Locals are destroyed on both paths") {
+        destroyed_locals = 0;
+        REQUIRE(with_local("1").unwrap() == 1);
+        REQUIRE(with_local("x").is_err());
+        REQUIRE(destroyed_locals == 2);
+    }
+    SECTION("The error is moved, not copied") {
+        Counted::reset();
+        auto result = take(C(err_tag, 5));
+        REQUIRE(result.err_unchecked().value == 5);
+        REQUIRE(Counted::counts.copies == 0);
+        Counted::reset();
+        REQUIRE(take(C(ok_tag, 5)).unwrap() == 5);
+        REQUIRE(Counted::counts.copies == 0);
+    }
+}
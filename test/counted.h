@@ -0,0 +1,74 @@
+#ifndef RESULT_TEST_COUNTED_H_3b1f9c2e_7d4a_4f60_8e2b_91c5a6d7e804
+#define RESULT_TEST_COUNTED_H_3b1f9c2e_7d4a_4f60_8e2b_91c5a6d7e804
+
+#include <ostream>
+
+// Tallies of the special member functions called on `Counted` objects.
+struct Counts {
+    int constructions = 0;
+    int copies = 0;
+    int moves = 0;
+    int copy_assignments = 0;
+    int move_assignments = 0;
+    int destructions = 0;
+
+    bool operator==(const Counts& other) const {
+        return constructions == other.constructions && copies == other.copies &&
+                moves == other.moves &&
+                copy_assignments == other.copy_assignments &&
+                move_assignments == other.move_assignments &&
+                destructions == other.destructions;
+    }
+    bool operator!=(const Counts& other) const { return !(*this == other); }
+};
+
+inline std::ostream& operator<<(std::ostream& stream, const Counts& counts) {
+    return stream << "{constructions: " << counts.constructions
+                  << ", copies: " << counts.copies
+                  << ", moves: " << counts.moves
+                  << ", copy_assignments: " << counts.copy_assignments
+                  << ", move_assignments: " << counts.move_assignments
+                  << ", destructions: " << counts.destructions << "}";
+}
+
+// A payload that records every construction, copy, move and destruction.
+class Counted {
+public:
+    static inline Counts counts;
+
+    static void reset() { counts = Counts(); }
+
+    Counted() noexcept { ++counts.constructions; }
+    explicit Counted(int value) noexcept : value(value) {
+        ++counts.constructions;
+    }
+    Counted(int a, int b) noexcept : value(a + b) { ++counts.constructions; }
+    Counted(const Counted& other) noexcept : value(other.value) {
+        ++counts.copies;
+    }
+    Counted(Counted&& other) noexcept : value(other.value) { ++counts.moves; }
+    Counted& operator=(const Counted& other) noexcept {
+        value = other.value;
+        ++counts.copy_assignments;
+        return *this;
+    }
+    Counted& operator=(Counted&& other) noexcept {
+        value = other.value;
+        ++counts.move_assignments;
+        return *this;
+    }
+    ~Counted() { ++counts.destructions; }
+
+    bool operator==(const Counted& other) const { return value == other.value; }
+    bool operator!=(const Counted& other) const { return value != other.value; }
+    bool operator<(const Counted& other) const { return value < other.value; }
+    bool operator<=(const Counted& other) const { return value <= other.value; }
+
+    int value = 0;
+};
+
+inline std::ostream& operator<<(std::ostream& stream, const Counted& counted) {
+    return stream << "Counted(" << counted.value << ")";
+}
+
+#endif
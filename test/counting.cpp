@@ -0,0 +1,280 @@
+// Copy/move accounting for every public operation of Result, Ok and Err.
+//
+// Each check runs one operation on a `Counted` payload and compares the
+// special member calls it made against the expected counts below. A change
+// in the header that adds a hidden copy or move fails here.
+
+#include <functional>
+#include <utility>
+
+#include <catch/catch.hpp>
+
+#include "result/result.h"
+
+#include "counted.h"
+
+using namespace result;
+
+namespace std {
+template <>
+struct hash<Counted> {
+    std::size_t operator()(const Counted& counted) const {
+        return std::hash<int>()(counted.value);
+    }
+};
+} // namespace std
+
+namespace {
+
+using R = Result<Counted, Counted>;
+
+Counts counts(int constructions,
+        int copies,
+        int moves,
+        int copy_assignments,
+        int move_assignments,
+        int destructions) {
+    Counts result;
+    result.constructions = constructions;
+    result.copies = copies;
+    result.moves = moves;
+    result.copy_assignments = copy_assignments;
+    result.move_assignments = move_assignments;
+    result.destructions = destructions;
+    return result;
+}
+
+template <typename F>
+Counts count(F&& fn) {
+    Counted::reset();
+    fn();
+    return Counted::counts;
+}
+
+R make_ok() { return R(ok_tag, 1); }
+R make_err() { return R(err_tag, 2); }
+
+Counted add_one(const Counted& x) { return Counted(x.value + 1); }
+R add_one_result(Counted x) { return R(ok_tag, x.value + 1); }
+Counted fallback(const Counted& x) { return Counted(x.value + 10); }
+R make_ok_lazily() { return R(ok_tag, 3); }
+
+} // namespace
+
+TEST_CASE("Ok and Err accounting", "[counting]") {
+    Counted value(1);
+
+    // clang-format off
+    REQUIRE(count([&] { Ok<Counted> ok(value); }) == counts(0, 1, 0, 0, 0, 1));
+    REQUIRE(count([&] { Ok<Counted> ok(std::move(value)); }) == counts(0, 0, 1, 0, 0, 1));
+    REQUIRE(count([&] { Err<Counted> err(value); }) == counts(0, 1, 0, 0, 0, 1));
+    REQUIRE(count([&] { Err<Counted> err(std::move(value)); }) == counts(0, 0, 1, 0, 0, 1));
+    // clang-format on
+
+    Ok<Counted> ok(value);
+    Err<Counted> err(value);
+
+    // clang-format off
+    REQUIRE(count([&] { const Counted& v = ok.value(); (void)v; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { const Counted& v = err.value(); (void)v; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { Counted v = std::move(ok).value(); }) == counts(0, 0, 1, 0, 0, 1));
+    REQUIRE(count([&] { Counted v = std::move(err).value(); }) == counts(0, 0, 1, 0, 0, 1));
+    // clang-format on
+}
+
+TEST_CASE("Result construction accounting", "[counting]") {
+    const Ok<Counted> ok(Counted(1));
+    const Err<Counted> err(Counted(2));
+    R source = make_ok();
+
+    // clang-format off
+    REQUIRE(count([&] { R r; }) == counts(1, 0, 0, 0, 0, 1));
+    REQUIRE(count([&] { R r(ok_tag, 1); }) == counts(1, 0, 0, 0, 0, 1));
+    REQUIRE(count([&] { R r(err_tag, 1, 2); }) == counts(1, 0, 0, 0, 0, 1));
+    REQUIRE(count([&] { R r = Ok(Counted(1)); }) == counts(1, 0, 2, 0, 0, 3));
+    REQUIRE(count([&] { R r = Err(Counted(1)); }) == counts(1, 0, 2, 0, 0, 3));
+    REQUIRE(count([&] { R r = ok; }) == counts(0, 1, 0, 0, 0, 1));
+    REQUIRE(count([&] { R r = err; }) == counts(0, 1, 0, 0, 0, 1));
+    REQUIRE(count([&] { R r = source; }) == counts(0, 1, 0, 0, 0, 1));
+    REQUIRE(count([&] { R r = std::move(source); }) == counts(0, 0, 1, 0, 0, 1));
+    REQUIRE(count([&] { R r = source.clone(); }) == counts(0, 1, 0, 0, 0, 1));
+    // clang-format on
+}
+
+TEST_CASE("Result assignment accounting", "[counting]") {
+    R ok = make_ok();
+    R err = make_err();
+    R target = make_ok();
+
+    // clang-format off
+    REQUIRE(count([&] { target = ok; }) == counts(0, 0, 0, 1, 0, 0));
+    REQUIRE(count([&] { target = std::move(ok); }) == counts(0, 0, 0, 0, 1, 0));
+    REQUIRE(count([&] { target = err; }) == counts(0, 1, 0, 0, 0, 1));
+    REQUIRE(count([&] { target = err; }) == counts(0, 0, 0, 1, 0, 0));
+    REQUIRE(count([&] { target = make_ok(); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { target.emplace_ok(3); }) == counts(1, 0, 0, 0, 0, 1));
+    REQUIRE(count([&] { target.emplace_err(3); }) == counts(1, 0, 0, 0, 0, 1));
+    // clang-format on
+}
+
+TEST_CASE("Result query and comparison accounting", "[counting]") {
+    const R ok = make_ok();
+    const R err = make_err();
+    const Ok<Counted> ok_value(Counted(1));
+    const Err<Counted> err_value(Counted(2));
+    bool b = false;
+
+    // clang-format off
+    REQUIRE(count([&] { b = ok.is_ok() && err.is_err(); }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { b = ok.kind() == ResultKind::Ok && ok; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { b = ok == ok_value; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { b = ok != ok_value; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { b = err == err_value; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { b = err != err_value; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { b = ok == err; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { b = ok != err; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { b = ok < err && ok <= err; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { b = ok > err || ok >= err; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { b = ok < ok_value && ok <= ok_value; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { b = ok > ok_value || ok >= ok_value; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { b = ok < err_value && ok <= err_value; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { b = ok > err_value || ok >= err_value; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { b = std::hash<R>()(ok) == 0; }) == counts(0, 0, 0, 0, 0, 0));
+    // clang-format on
+    (void)b;
+}
+
+TEST_CASE("Result accessor accounting", "[counting]") {
+    R ok = make_ok();
+    R err = make_err();
+    const R& const_ok = ok;
+    const R& const_err = err;
+
+    // clang-format off
+    REQUIRE(count([&] { auto v = const_ok.ok(); (void)v; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { auto v = ok.ok(); (void)v; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { auto v = const_err.err(); (void)v; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { auto v = err.err(); (void)v; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { const Counted& v = const_ok.try_ok(); (void)v; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { Counted& v = ok.try_ok(); (void)v; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { const Counted& v = const_err.try_err(); (void)v; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { Counted& v = err.try_err(); (void)v; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { Counted v = const_ok.unwrap(); }) == counts(0, 1, 0, 0, 0, 1));
+    REQUIRE(count([&] { Counted v = const_err.unwrap_err(); }) == counts(0, 1, 0, 0, 0, 1));
+    REQUIRE(count([&] { Counted v = const_ok.expect("ok"); }) == counts(0, 1, 0, 0, 0, 1));
+    REQUIRE(count([&] { Counted v = const_ok.unwrap_or(Counted(5)); }) == counts(1, 1, 0, 0, 0, 2));
+    REQUIRE(count([&] { Counted v = const_ok.unwrap_unchecked(); }) == counts(0, 1, 0, 0, 0, 1));
+    REQUIRE(count([&] { const Counted& v = const_ok.ok_unchecked(); (void)v; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { const Counted& v = const_err.err_unchecked(); (void)v; }) == counts(0, 0, 0, 0, 0, 0));
+    REQUIRE(count([&] { auto v = make_ok().ok(); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { auto v = make_err().err(); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { Counted v = make_ok().unwrap(); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { Counted v = make_err().unwrap_err(); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { Counted v = make_ok().expect("ok"); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { Counted v = make_err().expect_err("err"); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { Counted v = make_ok().unwrap_or(Counted(5)); }) == counts(2, 0, 1, 0, 0, 3));
+    REQUIRE(count([&] { Counted v = make_err().unwrap_or(Counted(5)); }) == counts(2, 0, 1, 0, 0, 3));
+    REQUIRE(count([&] { Counted v = make_err().unwrap_err_or(Counted(5)); }) == counts(2, 0, 1, 0, 0, 3));
+    REQUIRE(count([&] { Counted v = make_ok().unwrap_or_else(fallback); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { Counted v = make_err().unwrap_or_else(fallback); }) == counts(2, 0, 0, 0, 0, 2));
+    REQUIRE(count([&] { Counted v = make_err().unwrap_err_or_else(fallback); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { Counted v = make_ok().unwrap_err_or_else(fallback); }) == counts(2, 0, 0, 0, 0, 2));
+    REQUIRE(count([&] { Counted v = make_ok().unwrap_or_default(); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { Counted v = make_err().unwrap_err_or_default(); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { Counted v = make_ok().ok_unchecked(); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { Counted v = make_err().err_unchecked(); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { Counted v = make_ok().unwrap_unchecked(); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { Counted v = make_err().unwrap_err_unchecked(); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { Counted v = make_err().unwrap_or_default(); }) == counts(2, 0, 0, 0, 0, 2));
+    REQUIRE(count([&] { Counted v = make_ok().unwrap_err_or_default(); }) == counts(2, 0, 0, 0, 0, 2));
+    // clang-format on
+}
+
+TEST_CASE("Result combinator accounting", "[counting]") {
+    R ok = make_ok();
+    R err = make_err();
+    auto to_err = [](Counted x) { return R(err_tag, x.value); };
+
+    // clang-format off
+    REQUIRE(count([&] { R r = make_ok().map(add_one); }) == counts(2, 0, 1, 0, 0, 3));
+    REQUIRE(count([&] { R r = make_err().map(add_one); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { R r = make_ok().map_err(add_one); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { R r = make_err().map_err(add_one); }) == counts(2, 0, 1, 0, 0, 3));
+    REQUIRE(count([&] { R r = make_ok().and_(make_ok()); }) == counts(2, 0, 1, 0, 0, 3));
+    REQUIRE(count([&] { R r = make_err().and_(make_ok()); }) == counts(2, 0, 1, 0, 0, 3));
+    REQUIRE(count([&] { R r = make_ok().and_then(add_one_result); }) == counts(2, 0, 1, 0, 0, 3));
+    REQUIRE(count([&] { R r = make_err().and_then(add_one_result); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { R r = make_ok().or_(make_err()); }) == counts(2, 0, 1, 0, 0, 3));
+    REQUIRE(count([&] { R r = make_err().or_(make_ok()); }) == counts(2, 0, 1, 0, 0, 3));
+    REQUIRE(count([&] { R r = make_ok().or_else(to_err); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { R r = make_err().or_else(to_err); }) == counts(2, 0, 1, 0, 0, 3));
+    REQUIRE(count([&] { R r = make_ok().and_(make_ok_lazily); }) == counts(2, 0, 0, 0, 0, 2));
+    REQUIRE(count([&] { R r = make_err().and_(make_ok_lazily); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { R r = make_ok().or_(make_ok_lazily); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { R r = make_err().or_(make_ok_lazily); }) == counts(2, 0, 0, 0, 0, 2));
+    REQUIRE(count([&] { Counted v = make_ok().map_or(Counted(5), add_one); }) == counts(3, 0, 0, 0, 0, 3));
+    REQUIRE(count([&] { Counted v = make_err().map_or(Counted(5), add_one); }) == counts(2, 0, 1, 0, 0, 3));
+    REQUIRE(count([&] { Counted v = make_ok().map_or_else(add_one, add_one); }) == counts(2, 0, 0, 0, 0, 2));
+    REQUIRE(count([&] { Counted v = make_err().map_or_else(add_one, add_one); }) == counts(2, 0, 0, 0, 0, 2));
+    // clang-format on
+}
+
+TEST_CASE("Lvalue combinator accounting", "[counting]") {
+    R ok = make_ok();
+    R err = make_err();
+    const R& const_ok = ok;
+    const R& const_err = err;
+    auto add_one_ref = [](const Counted& x) { return R(ok_tag, x.value + 1); };
+    auto to_err_ref = [](const Counted& x) { return R(err_tag, x.value); };
+    auto bump = [](Counted& x) { return Counted(++x.value); };
+
+    // The payload is passed by reference and the untouched side is copied.
+    // clang-format off
+    REQUIRE(count([&] { R r = const_ok.map(add_one); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { R r = const_err.map(add_one); }) == counts(0, 1, 0, 0, 0, 1));
+    REQUIRE(count([&] { R r = const_ok.map_err(add_one); }) == counts(0, 1, 0, 0, 0, 1));
+    REQUIRE(count([&] { R r = const_err.map_err(add_one); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { R r = const_ok.and_(make_ok()); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { R r = const_err.and_(make_ok()); }) == counts(1, 1, 0, 0, 0, 2));
+    REQUIRE(count([&] { R r = const_ok.and_then(add_one_ref); }) == counts(1, 0, 0, 0, 0, 1));
+    REQUIRE(count([&] { R r = const_err.and_then(add_one_ref); }) == counts(0, 1, 0, 0, 0, 1));
+    REQUIRE(count([&] { R r = const_ok.or_(make_err()); }) == counts(1, 1, 0, 0, 0, 2));
+    REQUIRE(count([&] { R r = const_err.or_(make_ok()); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { R r = const_ok.or_else(to_err_ref); }) == counts(0, 1, 0, 0, 0, 1));
+    REQUIRE(count([&] { R r = const_err.or_else(to_err_ref); }) == counts(1, 0, 0, 0, 0, 1));
+    REQUIRE(count([&] { R r = ok.map(bump); }) == counts(1, 0, 1, 0, 0, 2));
+    REQUIRE(count([&] { R r = err.map_err(bump); }) == counts(1, 0, 1, 0, 0, 2));
+    // clang-format on
+
+    // A non-const lvalue is handed to `fn` as a mutable reference and is
+    // neither moved from nor copied.
+    REQUIRE(ok.ok_unchecked().value == 2);
+    REQUIRE(err.err_unchecked().value == 3);
+}
+
+TEST_CASE("Chained combinator accounting", "[counting]") {
+    auto add_one_result_ref = [](Counted&& x) {
+        return R(ok_tag, x.value + 1);
+    };
+
+    // Each `map` builds one value and moves it into its Result once; the
+    // Results themselves are elided.
+    REQUIRE(count([&] {
+        R r = make_ok().map(add_one).map(add_one).map(add_one);
+        REQUIRE(r.ok_unchecked().value == 4);
+    }) == counts(4, 0, 3, 0, 0, 7));
+    REQUIRE(count([&] {
+        R r = make_ok().map(add_one).and_then(add_one_result_ref).map(add_one);
+        REQUIRE(r.ok_unchecked().value == 4);
+    }) == counts(4, 0, 2, 0, 0, 6));
+
+    // An Err travels through the chain with one move per step and no copies.
+    REQUIRE(count([&] {
+        R r = make_err().map(add_one).and_then(add_one_result_ref).map(add_one);
+        REQUIRE(r.err_unchecked().value == 2);
+    }) == counts(1, 0, 3, 0, 0, 4));
+    REQUIRE(count([&] {
+        R r = make_err().map_err(add_one).map(add_one).map_err(add_one);
+        REQUIRE(r.err_unchecked().value == 4);
+    }) == counts(3, 0, 3, 0, 0, 6));
+}
@@ -0,0 +1,68 @@
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <catch/catch.hpp>
+
+#include "result/io.h"
+#include "result/result.h"
+
+using namespace result;
+
+namespace {
+
+using Bytes6 = std::array<std::uint8_t, 6>;
+
+static_assert(details::storage_layout<Bytes6, std::uint32_t> ==
+        details::StorageLayout::TagInPadding);
+static_assert(sizeof(Result<Bytes6, std::uint32_t>) == 8);
+static_assert(sizeof(Result<std::uint32_t, std::uint8_t>) == 8);
+
+static_assert(sizeof(PackedResult<std::uint32_t, std::uint8_t>) == 5);
+static_assert(alignof(PackedResult<std::uint32_t, std::uint8_t>) == 1);
+static_assert(sizeof(PackedResult<double, std::uint16_t>) == 9);
+static_assert(sizeof(PackedResult<int*, unit_t>) == sizeof(int*));
+
+} // namespace
+
+TEST_CASE("Tag in padding", "[layout]") {
+    Bytes6 bytes = {1, 2, 3, 4, 5, 6};
+    auto result1 = Result<Bytes6, std::uint32_t>(Ok(bytes));
+    auto result2 = Result<Bytes6, std::uint32_t>(Err(0xffffffffu));
+
+    REQUIRE(result1.is_ok());
+    REQUIRE(result1.ok_unchecked() == bytes);
+    REQUIRE(result2.is_err());
+    REQUIRE(result2.err_unchecked() == 0xffffffffu);
+
+    result1.ok_unchecked().fill(0xff);
+    REQUIRE(result1.is_ok());
+    result2 = result1;
+    REQUIRE(result2.is_ok());
+}
+
+TEST_CASE("Packed results", "[layout]") {
+    SECTION("Tagged") {
+        std::vector<PackedResult<double, std::uint16_t>> results;
+        results.push_back(Ok(2.5));
+        results.push_back(Err(std::uint16_t(7)));
+
+        REQUIRE(results[0].is_ok());
+        REQUIRE(results[0].load() == Ok(2.5));
+        REQUIRE(results[1].is_err());
+        REQUIRE(results[1].load() == Err(std::uint16_t(7)));
+
+        results[0].store(Result<double, std::uint16_t>(Err(std::uint16_t(3))));
+        REQUIRE(results[0].load() == Err(std::uint16_t(3)));
+    }
+    SECTION("Niche") {
+        int x = 5;
+        auto packed1 = PackedResult<int*, unit_t>(Ok(&x));
+        auto packed2 = PackedResult<int*, unit_t>(Err(unit));
+
+        REQUIRE(packed1.is_ok());
+        REQUIRE(*packed1.load().unwrap() == 5);
+        REQUIRE(packed2.is_err());
+    }
+}
@@ -0,0 +1,121 @@
+// Prints the sizeof/alignof of Result and PackedResult for a matrix of common
+// payload types as a Markdown table. With a file argument, compares the
+// report against that file instead and fails on any difference, which is how
+// doc/layout.md is kept from regressing.
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "result/result.h"
+
+using namespace result;
+
+namespace {
+
+enum class ErrCode : std::uint8_t { NotFound, Invalid, Count };
+enum class Handle : std::uint32_t { Invalid = 0 };
+
+} // namespace
+
+namespace result {
+template <>
+struct niche_traits<ErrCode> : sentinel_niche<ErrCode, ErrCode::Count> {};
+template <>
+struct niche_traits<Handle> : sentinel_niche<Handle, Handle::Invalid> {};
+} // namespace result
+
+namespace {
+
+template <typename T>
+struct type_name;
+
+#define RESULT_TYPE_NAME(type)                                                 \
+    template <>                                                                \
+    struct type_name<type> {                                                   \
+        static constexpr const char* value = #type;                            \
+    };
+
+RESULT_TYPE_NAME(unit_t)
+RESULT_TYPE_NAME(std::uint8_t)
+RESULT_TYPE_NAME(std::uint16_t)
+RESULT_TYPE_NAME(std::uint32_t)
+RESULT_TYPE_NAME(std::uint64_t)
+RESULT_TYPE_NAME(float)
+RESULT_TYPE_NAME(double)
+RESULT_TYPE_NAME(void*)
+RESULT_TYPE_NAME(Handle)
+RESULT_TYPE_NAME(ErrCode)
+using Bytes6 = std::array<std::uint8_t, 6>;
+RESULT_TYPE_NAME(Bytes6)
+
+#undef RESULT_TYPE_NAME
+
+const char* layout_name(details::StorageLayout layout) {
+    switch(layout) {
+    case details::StorageLayout::TagAfter:
+        return "tag after";
+    case details::StorageLayout::TagInPadding:
+        return "tag in padding";
+    case details::StorageLayout::NicheInOk:
+        return "niche in Ok";
+    case details::StorageLayout::NicheInErr:
+        return "niche in Err";
+    }
+    return "";
+}
+
+template <typename T, typename E>
+void row(std::ostream& out) {
+    out << "| `" << type_name<T>::value << "` | `" << type_name<E>::value
+        << "` | " << sizeof(Result<T, E>) << " | " << alignof(Result<T, E>)
+        << " | " << sizeof(PackedResult<T, E>) << " | "
+        << layout_name(details::storage_layout<T, E>) << " |\n";
+}
+
+template <typename T, typename... Es>
+void rows(std::ostream& out) {
+    (row<T, Es>(out), ...);
+}
+
+template <typename... Ts>
+void matrix(std::ostream& out) {
+    (rows<Ts, unit_t, std::uint8_t, std::uint16_t, std::uint32_t, ErrCode>(out),
+            ...);
+}
+
+std::string report() {
+    std::ostringstream out;
+    out << "# Result layout report\n\n"
+        << "Generated by `layout_report` (test/layout_report.cpp) for LP64 "
+           "targets.\n"
+        << "Run `layout_report > doc/layout.md` to regenerate it.\n\n"
+        << "| T | E | sizeof | alignof | sizeof packed | layout |\n"
+        << "|---|---|---|---|---|---|\n";
+    matrix<unit_t, std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t,
+            float, double, void*, Handle, Bytes6>(out);
+    return out.str();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if(argc < 2) {
+        std::cout << report();
+        return 0;
+    }
+
+    std::ifstream file(argv[1]);
+    std::stringstream expected;
+    expected << file.rdbuf();
+    if(!file || expected.str() != report()) {
+        std::cerr << "Result layout differs from " << argv[1]
+                  << ". Regenerate it with `layout_report > " << argv[1]
+                  << "` if the change is intended.\n";
+        return 1;
+    }
+    return 0;
+}
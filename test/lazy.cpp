@@ -0,0 +1,159 @@
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <catch/catch.hpp>
+
+#include "result/io.h"
+#include "result/result.h"
+
+#include "counted.h"
+
+using namespace result;
+using namespace std::literals::string_literals;
+
+namespace {
+
+using R = Result<int, std::string>;
+
+int add_one(int x) { return x + 1; }
+R halve(int x) {
+    if(x % 2 != 0) {
+        return R(err_tag, "odd"s);
+    }
+    return R(ok_tag, x / 2);
+}
+std::string shout(std::string error) { return error + "!"; }
+R recover(const std::string& error) {
+    if(error == "odd") {
+        return R(ok_tag, 0);
+    }
+    return R(err_tag, error);
+}
+
+// A pipeline refers to its source, so it cannot be started from a temporary.
+template <typename Source, typename = void>
+struct can_start_lazy : std::false_type {};
+template <typename Source>
+struct can_start_lazy<Source,
+        std::void_t<decltype(std::declval<Source>().lazy())>>
+    : std::true_type {};
+static_assert(can_start_lazy<R&>::value);
+static_assert(!can_start_lazy<R>::value);
+
+// Runs the same chain eagerly and lazily so both paths can be compared.
+R eager(R source) {
+    return std::move(source)
+            .map(add_one)
+            .and_then(halve)
+            .map_err(shout)
+            .map(add_one)
+            .or_else(recover);
+}
+R lazy(R source) {
+    return source.lazy()
+            .map(add_one)
+            .and_then(halve)
+            .map_err(shout)
+            .map(add_one)
+            .or_else(recover)
+            .collect();
+}
+
+constexpr int twice(int x) { return x * 2; }
+constexpr Result<int, int> check_small(int x) {
+    if(x > 10) {
+        return Result<int, int>(err_tag, x);
+    }
+    return Result<int, int>(ok_tag, x);
+}
+constexpr Result<int, int> lazy_constexpr(int x) {
+    Result<int, int> source(ok_tag, x);
+    return source.lazy()
+            .map(twice)
+            .and_then(check_small)
+            .map(twice)
+            .collect();
+}
+
+static_assert(lazy_constexpr(2) == Ok(8));
+static_assert(lazy_constexpr(6) == Err(12));
+
+} // namespace
+
+TEST_CASE("Lazy pipelines", "[lazy]") {
+    SECTION("Match the eager combinators") {
+        for(int x : {0, 1, 2, 3, 10}) {
+            REQUIRE(lazy(R(ok_tag, x)) == eager(R(ok_tag, x)));
+        }
+        REQUIRE(lazy(R(err_tag, "odd"s)) == eager(R(err_tag, "odd"s)));
+        REQUIRE(lazy(R(err_tag, "bad"s)) == eager(R(err_tag, "bad"s)));
+    }
+    SECTION("Switch sides through and_then and or_else") {
+        REQUIRE(lazy(R(ok_tag, 1)) == Ok(2));
+        REQUIRE(lazy(R(ok_tag, 2)) == Err("odd!"s));
+        REQUIRE(lazy(R(err_tag, "bad"s)) == Err("bad!"s));
+        R three(ok_tag, 3);
+        REQUIRE(three.lazy().and_then(halve).collect() == Err("odd"s));
+        R odd(err_tag, "odd"s);
+        REQUIRE(odd.lazy().or_else(recover).collect() == Ok(0));
+    }
+    SECTION("Change the value and error types") {
+        R four(ok_tag, 4);
+        auto result = four.lazy()
+                              .map([](int x) { return x * 0.5; })
+                              .map_err([](std::string e) { return e.size(); })
+                              .collect();
+        static_assert(std::is_same<decltype(result),
+                Result<double, std::size_t>>::value);
+        REQUIRE(result == Ok(2.0));
+    }
+    SECTION("An empty pipeline returns the source") {
+        R five(ok_tag, 5);
+        REQUIRE(five.lazy().collect() == Ok(5));
+        R bad(err_tag, "bad"s);
+        REQUIRE(bad.lazy().collect() == Err("bad"s));
+    }
+    SECTION("A stored pipeline is collected later") {
+        R source(ok_tag, 4);
+        auto pipeline = source.lazy().map(add_one).map_err(shout);
+        auto moved = std::move(pipeline).and_then(halve);
+        R result = std::move(moved).collect();
+        REQUIRE(result == Err("odd"s));
+    }
+}
+
+TEST_CASE("Lazy pipeline accounting", "[lazy][counting]") {
+    using C = Result<Counted, Counted>;
+    auto add = [](Counted&& x) { return Counted(x.value + 1); };
+    auto add_result = [](Counted&& x) { return C(ok_tag, x.value + 1); };
+
+    // Intermediate values are handed from stage to stage by reference; only
+    // the final value is moved, into the returned Result.
+    Counted::reset();
+    {
+        C source(ok_tag, 0);
+        C r = source.lazy().map(add).map(add).map(add).collect();
+        REQUIRE(r.ok_unchecked().value == 3);
+    }
+    REQUIRE(Counted::counts.constructions == 4);
+    REQUIRE(Counted::counts.copies == 0);
+    REQUIRE(Counted::counts.moves == 1);
+    REQUIRE(Counted::counts.destructions == 5);
+
+    // An Err skips every stage and is moved once.
+    Counted::reset();
+    {
+        C source(err_tag, 0);
+        C r = source.lazy()
+                      .map(add)
+                      .and_then(add_result)
+                      .map(add)
+                      .collect();
+        REQUIRE(r.err_unchecked().value == 0);
+    }
+    REQUIRE(Counted::counts.constructions == 1);
+    REQUIRE(Counted::counts.copies == 0);
+    REQUIRE(Counted::counts.moves == 1);
+    REQUIRE(Counted::counts.destructions == 2);
+}
@@ -0,0 +1,135 @@
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <system_error>
+
+#include <catch/catch.hpp>
+
+#include "result/io.h"
+#include "result/result.h"
+
+namespace {
+
+struct Foo {
+    int x;
+};
+
+enum class Handle : std::uint32_t { Invalid = 0 };
+enum class ErrCode : std::uint8_t { NotFound, Invalid, Count };
+
+std::ostream& operator<<(std::ostream& stream, Handle handle) {
+    return stream << static_cast<std::uint32_t>(handle);
+}
+std::ostream& operator<<(std::ostream& stream, ErrCode code) {
+    return stream << static_cast<unsigned>(code);
+}
+
+} // namespace
+
+namespace result {
+template <>
+struct niche_traits<Handle> : sentinel_niche<Handle, Handle::Invalid> {};
+template <>
+struct niche_traits<ErrCode> : sentinel_niche<ErrCode, ErrCode::Count> {};
+} // namespace result
+
+using namespace result;
+
+namespace {
+
+struct Empty {};
+
+// sizeof table: every niche-able Result is exactly the size of its payload,
+// while the same payload without a niche needs a tag and its padding.
+static_assert(sizeof(Result<Foo*, unit_t>) == sizeof(Foo*));
+static_assert(sizeof(Result<const char*, unit_t>) == sizeof(const char*));
+static_assert(sizeof(Result<Handle, unit_t>) == sizeof(Handle));
+static_assert(sizeof(Result<Handle, Empty>) == sizeof(Handle));
+static_assert(sizeof(Result<unit_t, Handle>) == sizeof(Handle));
+static_assert(sizeof(Result<unit_t, ErrCode>) == sizeof(ErrCode));
+
+static_assert(sizeof(Result<std::uintptr_t, unit_t>) > sizeof(Foo*));
+static_assert(sizeof(Result<std::uint32_t, unit_t>) > sizeof(Handle));
+static_assert(sizeof(Result<Foo*, int>) > sizeof(Foo*));
+
+static_assert(std::is_trivially_copyable<Result<Foo*, unit_t>>::value);
+static_assert(std::is_trivially_copyable<Result<unit_t, ErrCode>>::value);
+
+} // namespace
+
+TEST_CASE("Niche storage", "[niche]") {
+    SECTION("Pointer payload") {
+        Foo foo{5};
+        auto result1 = Result<Foo*, unit_t>(Ok(&foo));
+        auto result2 = Result<Foo*, unit_t>(Err(unit));
+        auto result3 = Result<Foo*, unit_t>(ok_tag, nullptr);
+
+        REQUIRE(result1.is_ok());
+        REQUIRE(result1.unwrap()->x == 5);
+        REQUIRE(result2.is_err());
+        REQUIRE(result3.is_ok());
+        REQUIRE(result3.unwrap() == nullptr);
+
+        result1 = result2;
+        REQUIRE(result1.is_err());
+
+        result1.emplace_ok(&foo);
+        REQUIRE(result1.is_ok());
+        result1.emplace_err();
+        REQUIRE(result1.is_err());
+    }
+    SECTION("Sentinel payload") {
+        auto result1 = Result<Handle, unit_t>(Ok(Handle(42)));
+        auto result2 = Result<Handle, unit_t>(err_tag);
+
+        REQUIRE(result1 == Ok(Handle(42)));
+        REQUIRE(result2.is_err());
+
+        result2 = result1;
+        REQUIRE(result2 == Ok(Handle(42)));
+    }
+    SECTION("Niche in the error") {
+        auto result1 = Result<unit_t, ErrCode>(Ok());
+        auto result2 = Result<unit_t, ErrCode>(Err(ErrCode::NotFound));
+
+        REQUIRE(result1.is_ok());
+        REQUIRE(result2.is_err());
+        REQUIRE(result2 == Err(ErrCode::NotFound));
+        REQUIRE(result1.map_err([](auto) { return 5; }) == Ok());
+    }
+}
+
+TEST_CASE("Status", "[niche]") {
+    static_assert(std::is_same<Status<ErrCode>, Result<unit_t, ErrCode>>::value);
+    static_assert(sizeof(Status<ErrCode>) == sizeof(ErrCode));
+    static_assert(sizeof(Status<std::error_code>) == sizeof(std::error_code));
+    static_assert(sizeof(Status<int>) > sizeof(int));
+
+    SECTION("Error code") {
+        auto ok = Status<std::error_code>(Ok());
+        auto err = Status<std::error_code>(
+                Err(std::make_error_code(std::errc::invalid_argument)));
+
+        REQUIRE(ok.is_ok());
+        REQUIRE(ok == Ok());
+        REQUIRE(err.is_err());
+        REQUIRE(err != Ok());
+        REQUIRE(err.unwrap_err() == std::errc::invalid_argument);
+    }
+    SECTION("Error code values") {
+        // Zero is a valid error_code value; its niche only serves errors.
+        static_assert(sizeof(Result<std::error_code, unit_t>) >
+                sizeof(std::error_code));
+        auto ok = Result<std::error_code, unit_t>(Ok(std::error_code()));
+        REQUIRE(ok.is_ok());
+        REQUIRE(ok.unwrap().value() == 0);
+    }
+    SECTION("Without a niche") {
+        auto ok = Status<int>(Ok());
+        auto err = Status<int>(Err(0));
+
+        REQUIRE(ok.is_ok());
+        REQUIRE(err.is_err());
+        REQUIRE(err == Err(0));
+    }
+}
@@ -0,0 +1,80 @@
+#include <cstring>
+#include <string>
+
+#include <catch/catch.hpp>
+
+#include "result/result.h"
+
+using namespace result;
+using namespace std::literals::string_literals;
+
+namespace {
+
+struct Panic {
+    std::string message;
+    source_location location;
+};
+
+void throwing_handler(
+        std::string_view message, const source_location& location) {
+    throw Panic{std::string(message), location};
+}
+
+// Installs `throwing_handler` for the duration of a test.
+class ScopedHandler {
+public:
+    ScopedHandler() : m_previous(set_panic_handler(&throwing_handler)) {}
+    ~ScopedHandler() { set_panic_handler(m_previous); }
+
+private:
+    panic_handler m_previous;
+};
+
+template <typename F>
+Panic catch_panic(F&& fn) {
+    try {
+        fn();
+    } catch(const Panic& panic) {
+        return panic;
+    }
+    return Panic{"no panic", source_location{}};
+}
+
+} // namespace
+
+TEST_CASE("Panic handler", "[panic]") {
+    auto ok = Result<int, std::string>(Ok(5));
+    auto err = Result<int, std::string>(Err("bad"s));
+
+    SECTION("Receives the message and the caller's location") {
+        ScopedHandler handler;
+
+        int line = __LINE__ + 1;
+        Panic panic = catch_panic([&] { (void)err.unwrap(); });
+        REQUIRE(panic.message == "Called `unwrap` on an Err value");
+        REQUIRE(panic.location.line == static_cast<unsigned>(line));
+        REQUIRE(std::strstr(panic.location.file, "panic.cpp") != nullptr);
+
+        panic = catch_panic([&] { (void)ok.expect_err("wanted an error"); });
+        REQUIRE(panic.message == "wanted an error");
+
+        panic = catch_panic([&] { (void)ok.try_err(); });
+        REQUIRE(panic.message == "Called `try_err` on an Ok value");
+        panic = catch_panic([&] { (void)std::move(ok).unwrap_err(); });
+        REQUIRE(panic.message == "Called `unwrap_err` on an Ok value");
+    }
+    SECTION("Is not called on success") {
+        ScopedHandler handler;
+
+        REQUIRE(ok.unwrap() == 5);
+        REQUIRE(err.unwrap_err() == "bad"s);
+        REQUIRE(ok.expect("ok") == 5);
+    }
+    SECTION("Registration returns the previous handler") {
+        panic_handler original = get_panic_handler();
+        REQUIRE(set_panic_handler(&throwing_handler) == original);
+        REQUIRE(get_panic_handler() == &throwing_handler);
+        REQUIRE(set_panic_handler(nullptr) == &throwing_handler);
+        REQUIRE(get_panic_handler() == original);
+    }
+}
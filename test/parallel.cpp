@@ -0,0 +1,265 @@
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch/catch.hpp>
+
+#include "result/io.h"
+#include "result/parallel.h"
+#include "result/result.h"
+
+using namespace result;
+
+namespace {
+
+using R = Result<int, std::string>;
+
+std::vector<int> iota(int count) {
+    std::vector<int> values(count);
+    for(int i = 0; i < count; ++i) {
+        values[i] = i;
+    }
+    return values;
+}
+
+} // namespace
+
+TEST_CASE("par_map", "[parallel]") {
+    ThreadPool pool(3);
+    ParallelOptions options;
+    options.pool = &pool;
+    options.chunk_size = 7;
+    const std::vector<int> input = iota(1000);
+
+    SECTION("All Ok") {
+        auto squares = par_map(input, [](int x) { return R(ok_tag, x * x); },
+                stop_on_first, options);
+        REQUIRE(squares.is_ok());
+        REQUIRE(squares.unwrap().size() == input.size());
+        for(int i = 0; i < 1000; ++i) {
+            REQUIRE(squares.unwrap()[i] == i * i);
+        }
+    }
+    SECTION("Returns the error of the lowest index") {
+        for(int run = 0; run < 20; ++run) {
+            auto checked = par_map(input,
+                    [](int x) {
+                        return x % 100 == 37 ? R(err_tag, std::to_string(x))
+                                             : R(ok_tag, x);
+                    },
+                    stop_on_first, options);
+            REQUIRE(checked.unwrap_err() == "37");
+        }
+    }
+    SECTION("Stops starting chunks after an error") {
+        const std::vector<int> large = iota(100000);
+        std::atomic<int> calls{0};
+        options.chunk_size = 16;
+        auto checked = par_map(large,
+                [&](int x) {
+                    ++calls;
+                    return x == 0 ? R(err_tag, "zero") : R(ok_tag, x);
+                },
+                stop_on_first, options);
+        REQUIRE(checked.unwrap_err() == "zero");
+        REQUIRE(calls < 100000);
+    }
+    SECTION("Collect all") {
+        std::atomic<int> calls{0};
+        std::vector<R> results = par_map(input,
+                [&](int x) {
+                    ++calls;
+                    return x % 2 ? R(err_tag, "odd") : R(ok_tag, x);
+                },
+                collect_all, options);
+        REQUIRE(calls == 1000);
+        REQUIRE(results.size() == 1000);
+        REQUIRE(results[10] == Ok(10));
+        REQUIRE(results[11] == Err(std::string("odd")));
+    }
+    SECTION("Empty range") {
+        auto none = par_map(
+                std::vector<int>(), [](int x) { return R(ok_tag, x); });
+        REQUIRE(none.unwrap().empty());
+    }
+    SECTION("Moves from an rvalue range") {
+        std::vector<std::string> words(100, std::string(32, 'w'));
+        auto lengths = par_map(std::move(words),
+                [](std::string&& word) {
+                    std::string taken = std::move(word);
+                    return R(ok_tag, static_cast<int>(taken.size()));
+                },
+                stop_on_first, options);
+        REQUIRE(lengths.unwrap()[99] == 32);
+        REQUIRE(words[0].empty());
+    }
+    SECTION("Rethrows exceptions") {
+        REQUIRE_THROWS_AS(par_map(input,
+                                  [](int x) -> R {
+                                      if(x == 500) {
+                                          throw std::runtime_error("boom");
+                                      }
+                                      return R(ok_tag, x);
+                                  },
+                                  stop_on_first, options),
+                std::runtime_error);
+    }
+    SECTION("Nested calls finish on a busy pool") {
+        ThreadPool small(1);
+        ParallelOptions inner;
+        inner.pool = &small;
+        inner.chunk_size = 1;
+        auto sums = par_map(iota(8),
+                [&](int x) {
+                    auto row = par_map(iota(x),
+                            [](int y) { return R(ok_tag, y); }, stop_on_first,
+                            inner);
+                    int sum = 0;
+                    for(int y : row.unwrap()) {
+                        sum += y;
+                    }
+                    return R(ok_tag, sum);
+                },
+                stop_on_first, inner);
+        REQUIRE(sums.unwrap()[7] == 21);
+    }
+    SECTION("Runs on the caller alone") {
+        ThreadPool none(0);
+        options.pool = &none;
+        auto doubled = par_map(input, [](int x) { return R(ok_tag, 2 * x); },
+                stop_on_first, options);
+        REQUIRE(doubled.unwrap()[999] == 1998);
+    }
+}
+
+TEST_CASE("par_and_then", "[parallel]") {
+    ThreadPool pool(3);
+    ParallelOptions options;
+    options.pool = &pool;
+    options.chunk_size = 5;
+
+    std::vector<R> parsed;
+    for(int i = 0; i < 200; ++i) {
+        parsed.push_back(i == 150 ? R(err_tag, "parse") : R(ok_tag, i));
+    }
+    auto validate = [](int x) {
+        return x == 180 ? R(err_tag, "range") : R(ok_tag, x + 1);
+    };
+
+    SECTION("Passes input errors through") {
+        auto checked = par_and_then(parsed, validate, stop_on_first, options);
+        REQUIRE(checked.unwrap_err() == "parse");
+    }
+    SECTION("Collect all") {
+        std::vector<R> checked =
+                par_and_then(parsed, validate, collect_all, options);
+        REQUIRE(checked[0] == Ok(1));
+        REQUIRE(checked[150] == Err(std::string("parse")));
+        REQUIRE(checked[180] == Err(std::string("range")));
+    }
+    SECTION("Converts the error of fn") {
+        auto widen = [](int x) {
+            return Result<long, const char*>(ok_tag, x * 10L);
+        };
+        parsed[150] = R(ok_tag, 150);
+        Result<std::vector<long>, std::string> checked =
+                par_and_then(std::move(parsed), widen, stop_on_first, options);
+        REQUIRE(checked.unwrap()[199] == 1990);
+    }
+}
+
+TEST_CASE("par_try_for_each", "[parallel]") {
+    ThreadPool pool(3);
+    ParallelOptions options;
+    options.pool = &pool;
+    options.chunk_size = 4;
+    const std::vector<int> input = iota(1000);
+    using S = Status<std::string>;
+
+    SECTION("All Ok") {
+        std::atomic<long> sum{0};
+        auto done = par_try_for_each(input,
+                [&](int x) {
+                    sum += x;
+                    return S(ok_tag);
+                },
+                options);
+        REQUIRE(done.is_ok());
+        REQUIRE(sum == 499500);
+    }
+    SECTION("Stops at an error") {
+        std::atomic<int> calls{0};
+        const std::vector<int> large = iota(100000);
+        auto done = par_try_for_each(large,
+                [&](int x) {
+                    ++calls;
+                    return x == 3 ? S(err_tag, "three") : S(ok_tag);
+                },
+                options);
+        REQUIRE(done == Err(std::string("three")));
+        REQUIRE(calls < 100000);
+    }
+    SECTION("Cancels the token of in-flight calls") {
+        // Element 0 waits for the token; it is only cancelled once element 1,
+        // in another chunk, fails. The error of element 0 is ignored.
+        options.chunk_size = 1;
+        auto done = par_try_for_each(iota(2),
+                [](int x, const CancellationToken& token) {
+                    if(x == 1) {
+                        return S(err_tag, "one");
+                    }
+                    while(!token.is_cancelled()) {
+                        std::this_thread::yield();
+                    }
+                    return S(err_tag, "cancelled");
+                },
+                options);
+        REQUIRE(done == Err(std::string("one")));
+    }
+}
+
+TEST_CASE("try_reduce", "[parallel]") {
+    ThreadPool pool(3);
+    ParallelOptions options;
+    options.pool = &pool;
+    const std::vector<int> input = iota(1001);
+    auto add = [](long a, long b) {
+        return Result<long, std::string>(ok_tag, a + b);
+    };
+
+    SECTION("Sums with any chunk size") {
+        for(std::size_t chunk : {0, 1, 3, 64, 5000}) {
+            options.chunk_size = chunk;
+            REQUIRE(try_reduce(input, 0L, add, options) == Ok(500500L));
+        }
+    }
+    SECTION("Combines in order") {
+        // Concatenation is associative but not commutative.
+        std::vector<std::string> letters;
+        for(char c = 'a'; c <= 'z'; ++c) {
+            letters.emplace_back(1, c);
+        }
+        options.chunk_size = 3;
+        auto joined = try_reduce(letters, std::string(),
+                [](std::string a, std::string b) {
+                    return Result<std::string, int>(ok_tag, a + b);
+                },
+                options);
+        REQUIRE(joined.unwrap() == "abcdefghijklmnopqrstuvwxyz");
+    }
+    SECTION("Returns an error of op") {
+        options.chunk_size = 10;
+        auto bounded = [](long a, long b) {
+            return a + b > 100000 ? Result<long, std::string>(err_tag, "big")
+                                  : Result<long, std::string>(ok_tag, a + b);
+        };
+        REQUIRE(try_reduce(input, 0L, bounded, options) ==
+                Err(std::string("big")));
+    }
+    SECTION("Empty range") {
+        REQUIRE(try_reduce(std::vector<int>(), 7L, add, options) == Ok(7L));
+    }
+}
@@ -2,11 +2,15 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include <catch/catch.hpp>
 
+#include "result/io.h"
 #include "result/result.h"
 
+#include "counted.h"
+
 using namespace result;
 using namespace std::literals::string_literals;
 
@@ -39,6 +43,46 @@ TEST_CASE("Result construction", "[result]") {
         REQUIRE(result == Err(std::string("Hello world")));
         REQUIRE(result != Ok(5));
     }
+    SECTION("Converting Ok and Err") {
+        Result<double, std::string> result1 = Ok(5);
+        const char* message = "bad";
+        Result<double, std::string> result2 = Err(message);
+        const auto ok = Ok(2);
+        Result<long, int> result3 = ok;
+
+        REQUIRE(result1 == Ok(5.0));
+        REQUIRE(result2 == Err("bad"s));
+        REQUIRE(result3 == Ok(2L));
+    }
+    SECTION("Construction from Ok and Err moves twice") {
+        Counted value(1);
+        Counted::reset();
+        Result<Counted, int> result1 = Ok(std::move(value));
+
+        // One move into the Ok wrapper and one into the Result.
+        Counts expected;
+        expected.moves = 2;
+        expected.destructions = 1;
+        REQUIRE(Counted::counts == expected);
+
+        Counted::reset();
+        Result<int, Counted> result2 = Err(Counted(2));
+        expected = Counts();
+        expected.constructions = 1;
+        expected.moves = 2;
+        expected.destructions = 2;
+        REQUIRE(Counted::counts == expected);
+
+        Counted::reset();
+        const auto ok = Ok(Counted(3));
+        Result<Counted, int> result3 = ok;
+        expected = Counts();
+        expected.constructions = 1;
+        expected.moves = 1;
+        expected.copies = 1;
+        expected.destructions = 1;
+        REQUIRE(Counted::counts == expected);
+    }
     SECTION("Ok with unit type") {
         auto result = Result<unit_t, int>(Ok());
 
@@ -84,6 +128,137 @@ TEST_CASE("Result copy/move", "[result]") {
             REQUIRE(result2 == Ok(str));
         }
     }
+    SECTION("Assignment reuses the held value") {
+        {
+            auto result1 = Result<std::vector<int>, int>(
+                    Ok(std::vector<int>(100, 1)));
+            auto result2 =
+                    Result<std::vector<int>, int>(Ok(std::vector<int>(10, 2)));
+            const int* data = result1.ok_unchecked().data();
+
+            result1 = result2;
+            REQUIRE(result1.ok_unchecked() == std::vector<int>(10, 2));
+            REQUIRE(result1.ok_unchecked().data() == data);
+        }
+        {
+            auto result1 = Result<std::string, int>(Ok("first"s));
+            auto result2 = Result<std::string, int>(Err(5));
+
+            result1 = result2;
+            REQUIRE(result1 == Err(5));
+            result1 = Result<std::string, int>(Ok("second"s));
+            REQUIRE(result1 == Ok("second"s));
+        }
+    }
+    SECTION("Assignment noexcept") {
+        static_assert(
+                std::is_nothrow_move_assignable<Result<std::string, int>>::value);
+        static_assert(
+                !std::is_nothrow_copy_assignable<Result<std::string, int>>::value);
+        static_assert(std::is_nothrow_copy_assignable<Result<int, int>>::value);
+    }
+}
+
+namespace {
+
+// Throws when constructed from a negative number. Its moves may throw too, so
+// Result cannot build it in a temporary and move it into place.
+struct Fragile {
+    static inline int live = 0;
+
+    explicit Fragile(int value) : value(value) {
+        if(value < 0) {
+            throw value;
+        }
+        ++live;
+    }
+    Fragile(const Fragile& other) : value(other.value) { ++live; }
+    Fragile(Fragile&& other) noexcept(false) : value(other.value) { ++live; }
+    Fragile& operator=(const Fragile&) = default;
+    Fragile& operator=(Fragile&&) noexcept(false) = default;
+    ~Fragile() { --live; }
+
+    int value;
+};
+
+} // namespace
+
+TEST_CASE("Result emplace", "[result]") {
+    SECTION("Default construction") {
+        Counted::reset();
+        {
+            Result<Counted, int> result;
+            REQUIRE(result.is_ok());
+        }
+        Counts expected;
+        expected.constructions = 1;
+        expected.destructions = 1;
+        REQUIRE(Counted::counts == expected);
+
+        REQUIRE(Result<int, std::string>() == Ok(0));
+    }
+    SECTION("emplace_ok") {
+        auto result = Result<Counted, int>(err_tag, 5);
+
+        Counted::reset();
+        Counted& value = result.emplace_ok(2, 3);
+        REQUIRE(result.is_ok());
+        REQUIRE(value.value == 5);
+        REQUIRE(&value == &result.ok_unchecked());
+
+        Counts expected;
+        expected.constructions = 1;
+        REQUIRE(Counted::counts == expected);
+
+        Counted::reset();
+        result.emplace_ok(7);
+        REQUIRE(result.ok_unchecked().value == 7);
+        expected.destructions = 1;
+        REQUIRE(Counted::counts == expected);
+    }
+    SECTION("emplace_err") {
+        auto result = Result<int, Counted>(ok_tag, 5);
+
+        Counted::reset();
+        result.emplace_err(1, 1);
+        REQUIRE(result.is_err());
+        REQUIRE(result.err_unchecked().value == 2);
+
+        Counts expected;
+        expected.constructions = 1;
+        REQUIRE(Counted::counts == expected);
+    }
+    SECTION("Strings") {
+        auto result = Result<std::string, int>(Err(5));
+
+        result.emplace_ok(3, 'a');
+        REQUIRE(result == Ok("aaa"s));
+        result.emplace_err(10);
+        REQUIRE(result == Err(10));
+    }
+    SECTION("Throwing constructions keep the old contents") {
+        Fragile::live = 0;
+        {
+            auto result = Result<Fragile, std::string>(err_tag, "old");
+            REQUIRE_THROWS_AS(result.emplace_ok(-1), int);
+            REQUIRE(result.is_err());
+            REQUIRE(result.err_unchecked() == "old");
+
+            result.emplace_ok(1);
+            REQUIRE(result.ok_unchecked().value == 1);
+            REQUIRE_THROWS_AS(result.emplace_ok(-2), int);
+            REQUIRE(result.ok_unchecked().value == 1);
+            REQUIRE(Fragile::live == 1);
+
+            auto other = Result<Fragile, std::string>(err_tag, "other");
+            result = other;
+            REQUIRE(result.is_err());
+            REQUIRE(result.err_unchecked() == "other");
+            result = Result<Fragile, std::string>(ok_tag, 3);
+            REQUIRE(result.ok_unchecked().value == 3);
+        }
+        REQUIRE(Fragile::live == 0);
+    }
 }
 
 double times2(double x) { return x * 2.0; }
@@ -163,6 +338,102 @@ TEST_CASE("Result combinators and adapters", "[result]") {
             }) == Ok(20));
         }
     }
+    SECTION("map_or and map_or_else") {
+        auto ok = Result<int, std::string>(Ok(5));
+        auto err = Result<int, std::string>(Err("cat"s));
+        auto twice = [](int x) { return x * 2; };
+        auto length = [](const std::string& e) { return int(e.size()); };
+
+        REQUIRE(ok.map_or(0, twice) == 10);
+        REQUIRE(err.map_or(0, twice) == 0);
+        REQUIRE(ok.map_or_else(length, twice) == 10);
+        REQUIRE(err.map_or_else(length, twice) == 3);
+        REQUIRE(std::move(err).map_or_else(
+                        [](std::string e) { return e + "s"; },
+                        [](int x) { return std::to_string(x); }) == "cats");
+    }
+    SECTION("Lazy and_ and or_") {
+        int calls = 0;
+        auto fallback = [&] {
+            ++calls;
+            return Result<int, int>(Ok(7));
+        };
+
+        REQUIRE(Result<int, int>(Ok(5)).and_(fallback) == Ok(7));
+        REQUIRE(Result<int, int>(Err(5)).and_(fallback) == Err(5));
+        REQUIRE(calls == 1);
+        REQUIRE(Result<int, int>(Err(5)).or_(fallback) == Ok(7));
+        REQUIRE(Result<int, int>(Ok(5)).or_(fallback) == Ok(5));
+        REQUIRE(calls == 2);
+    }
+}
+
+TEST_CASE("Result unwrap family", "[result]") {
+    auto ok = Result<std::string, std::string>(Ok("cat"s));
+    auto err = Result<std::string, std::string>(Err("dog"s));
+
+    SECTION("Lvalues are copied from and left intact") {
+        REQUIRE(ok.unwrap() == "cat"s);
+        REQUIRE(ok.expect("ok") == "cat"s);
+        REQUIRE(ok.unwrap_unchecked() == "cat"s);
+        REQUIRE(err.unwrap_err() == "dog"s);
+        REQUIRE(ok == Ok("cat"s));
+        REQUIRE(err == Err("dog"s));
+    }
+    SECTION("Fallbacks are returned by value") {
+        std::string value = err.unwrap_or("fish"s);
+        REQUIRE(value == "fish"s);
+        std::string fallback = std::move(err).unwrap_or_default();
+        REQUIRE(fallback.empty());
+        std::string error = std::move(ok).unwrap_err_or_default();
+        REQUIRE(error.empty());
+    }
+    SECTION("Rvalues are moved from") {
+        std::string value = std::move(ok).unwrap_unchecked();
+        REQUIRE(value == "cat"s);
+        std::string error = std::move(err).unwrap_err();
+        REQUIRE(error == "dog"s);
+    }
+}
+
+namespace {
+enum class LookupError { NotFound };
+} // namespace
+
+template <>
+struct result::ok_is_likely<LookupError> : std::false_type {};
+
+TEST_CASE("Branch hint opt-out", "[result]") {
+    auto found = Result<int, LookupError>(Ok(1));
+    auto missing = Result<int, LookupError>(Err(LookupError::NotFound));
+    auto add_one = [](int x) { return x + 1; };
+
+    REQUIRE(found.map(add_one).unwrap_or(0) == 2);
+    REQUIRE(missing.map(add_one).unwrap_or(0) == 0);
+    REQUIRE(missing.lazy().map(add_one).collect().is_err());
+}
+
+TEST_CASE("Ordering", "[result]") {
+    auto ok1 = Result<int, std::string>(Ok(1));
+    auto ok2 = Result<int, std::string>(Ok(2));
+    auto err = Result<int, std::string>(Err("bad"s));
+
+    REQUIRE(ok1 < ok2);
+    REQUIRE(ok1 <= ok2);
+    REQUIRE(ok2 > ok1);
+    // Errors sort before every Ok value and are equivalent to each other.
+    REQUIRE(err < ok1);
+    REQUIRE(ok2 > err);
+    REQUIRE_FALSE(ok1 < err);
+    REQUIRE_FALSE(err < err);
+    REQUIRE(err <= err);
+    REQUIRE(ok1 < Ok(2));
+    REQUIRE(ok1 >= Ok(1));
+    REQUIRE(ok1 > Err("bad"s));
+    REQUIRE_FALSE(ok1 < Err("bad"s));
+    REQUIRE(err >= Err("other"s));
+    REQUIRE(err <= Err("other"s));
+    REQUIRE(err < Ok(5));
 }
 
 TEST_CASE("Hash", "[result]") {
@@ -0,0 +1,88 @@
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+#include <catch/catch.hpp>
+
+#include "result/io.h"
+#include "result/result.h"
+
+using namespace result;
+
+namespace {
+
+enum class ErrCode : std::uint32_t { NotFound, Invalid };
+
+std::ostream& operator<<(std::ostream& stream, ErrCode code) {
+    return stream << static_cast<std::uint32_t>(code);
+}
+
+// The Itanium C++ ABI passes and returns a class in registers only if it is
+// trivially copyable and trivially destructible and fits in two eightbytes.
+template <typename R>
+constexpr bool passed_in_registers =
+        std::is_trivially_copyable<R>::value &&
+        std::is_trivially_destructible<R>::value &&
+        sizeof(R) <= 2 * sizeof(std::uint64_t);
+
+template <typename T, typename E>
+constexpr bool is_trivial_result =
+        std::is_trivially_copy_constructible<Result<T, E>>::value &&
+        std::is_trivially_move_constructible<Result<T, E>>::value &&
+        std::is_trivially_copy_assignable<Result<T, E>>::value &&
+        std::is_trivially_move_assignable<Result<T, E>>::value &&
+        std::is_trivially_destructible<Result<T, E>>::value;
+
+static_assert(is_trivial_result<int, int>);
+static_assert(is_trivial_result<std::uint64_t, ErrCode>);
+static_assert(is_trivial_result<double, int>);
+static_assert(is_trivial_result<unit_t, ErrCode>);
+static_assert(is_trivial_result<const int*, int>);
+
+static_assert(passed_in_registers<Result<int, int>>);
+static_assert(passed_in_registers<Result<std::uint64_t, ErrCode>>);
+static_assert(passed_in_registers<Result<double, int>>);
+static_assert(passed_in_registers<Result<unit_t, ErrCode>>);
+static_assert(passed_in_registers<Result<const int*, int>>);
+
+static_assert(!std::is_trivially_copy_constructible<
+              Result<std::string, int>>::value);
+static_assert(!std::is_trivially_destructible<Result<int, std::string>>::value);
+static_assert(std::is_copy_constructible<Result<std::string, int>>::value);
+static_assert(std::is_nothrow_move_constructible<
+        Result<std::string, int>>::value);
+
+Result<std::uint64_t, ErrCode> parse_digit(char c) {
+    if(c < '0' || c > '9') {
+        return Err(ErrCode::Invalid);
+    }
+    return Ok(static_cast<std::uint64_t>(c - '0'));
+}
+
+} // namespace
+
+TEST_CASE("Trivial results", "[triviality]") {
+    SECTION("Copy and assign") {
+        auto result1 = parse_digit('7');
+        auto result2 = parse_digit('x');
+
+        REQUIRE(result1 == Ok(std::uint64_t(7)));
+        REQUIRE(result2 == Err(ErrCode::Invalid));
+
+        result2 = result1;
+        REQUIRE(result2 == Ok(std::uint64_t(7)));
+    }
+    SECTION("Non-trivial alternatives") {
+        auto result1 = Result<int, std::string>(Err(std::string("a long "
+                                                                "enough string "
+                                                                "to allocate")));
+        auto result2 = Result<int, std::string>(Ok(5));
+
+        result2 = result1;
+        REQUIRE(result2 == result1);
+        result1 = Result<int, std::string>(Ok(10));
+        REQUIRE(result1 == Ok(10));
+        REQUIRE(result2 != result1);
+    }
+}
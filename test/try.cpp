@@ -0,0 +1,122 @@
+#include <string>
+
+#include <catch/catch.hpp>
+
+#include "result/io.h"
+#include "result/result.h"
+
+#include "counted.h"
+
+using namespace result;
+using namespace std::literals::string_literals;
+
+namespace {
+
+struct ParseError {
+    std::string what;
+};
+struct ConfigError {
+    ConfigError(ParseError error) : what("config: " + error.what) {}
+
+    std::string what;
+};
+
+Result<int, ParseError> parse(const std::string& text) {
+    if(text.empty() || text[0] < '0' || text[0] > '9') {
+        return Result<int, ParseError>(err_tag, ParseError{text});
+    }
+    return Result<int, ParseError>(ok_tag, text[0] - '0');
+}
+
+Result<int, ParseError> add(const std::string& a, const std::string& b) {
+    RESULT_TRY_ASSIGN(int x, parse(a));
+    RESULT_TRY_ASSIGN(int y, parse(b));
+    return Result<int, ParseError>(ok_tag, x + y);
+}
+
+// Each use gets its own hidden variable, even on one line.
+Result<int, ParseError> product(const std::string& a, const std::string& b) {
+    int x, y;
+    // clang-format off
+    RESULT_TRY_ASSIGN(x, parse(a)); RESULT_TRY_ASSIGN(y, parse(b));
+    // clang-format on
+    return Result<int, ParseError>(ok_tag, x * y);
+}
+
+#if defined(RESULT_HAS_STATEMENT_EXPRESSIONS)
+
+// The error is converted to the caller's error type and value type.
+Result<std::string, ConfigError> describe(const std::string& text) {
+    int value = RESULT_TRY(parse(text));
+    return Result<std::string, ConfigError>(ok_tag, std::to_string(value));
+}
+
+Result<int, ParseError> sum(const std::string& a, const std::string& b) {
+    return Result<int, ParseError>(
+            ok_tag, RESULT_TRY(parse(a)) + RESULT_TRY(parse(b)));
+}
+
+using C = Result<Counted, Counted>;
+
+Result<int, Counted> take_value(C&& result) {
+    Counted value = RESULT_TRY(std::move(result));
+    return Result<int, Counted>(ok_tag, value.value);
+}
+Result<int, Counted> peek_value(const C& result) {
+    Counted value = RESULT_TRY(result);
+    return Result<int, Counted>(ok_tag, value.value);
+}
+
+#endif
+
+} // namespace
+
+TEST_CASE("RESULT_TRY_ASSIGN", "[try]") {
+    REQUIRE(add("1", "2").unwrap() == 3);
+    REQUIRE(add("x", "2").unwrap_err().what == "x");
+    REQUIRE(add("1", "y").unwrap_err().what == "y");
+    REQUIRE(product("2", "3").unwrap() == 6);
+    REQUIRE(product("2", "z").unwrap_err().what == "z");
+}
+
+#if defined(RESULT_HAS_STATEMENT_EXPRESSIONS)
+
+TEST_CASE("RESULT_TRY", "[try]") {
+    SECTION("Yields the value") {
+        REQUIRE(describe("7").unwrap() == "7");
+        REQUIRE(sum("3", "4").unwrap() == 7);
+    }
+    SECTION("Converts the error") {
+        REQUIRE(describe("x").unwrap_err().what == "config: x");
+        REQUIRE(sum("3", "y").unwrap_err().what == "y");
+    }
+    SECTION("Moves the error out of an rvalue exactly once") {
+        Counted::reset();
+        auto result = take_value(C(err_tag, 5));
+        REQUIRE(result.err_unchecked().value == 5);
+        REQUIRE(Counted::counts.constructions == 1);
+        REQUIRE(Counted::counts.moves == 1);
+        REQUIRE(Counted::counts.copies == 0);
+    }
+    SECTION("Moves the value out of an rvalue exactly once") {
+        Counted::reset();
+        REQUIRE(take_value(C(ok_tag, 5)).unwrap() == 5);
+        REQUIRE(Counted::counts.moves == 1);
+        REQUIRE(Counted::counts.copies == 0);
+    }
+    SECTION("Copies from an lvalue and leaves it intact") {
+        C ok(ok_tag, 1);
+        C err(err_tag, 2);
+        Counted::reset();
+        auto from_ok = peek_value(ok);
+        auto from_err = peek_value(err);
+        REQUIRE(Counted::counts.copies == 2);
+        REQUIRE(Counted::counts.moves == 0);
+        REQUIRE(from_ok.ok_unchecked() == 1);
+        REQUIRE(from_err.err_unchecked().value == 2);
+        REQUIRE(ok.ok_unchecked().value == 1);
+        REQUIRE(err.err_unchecked().value == 2);
+    }
+}
+
+#endif
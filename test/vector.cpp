@@ -0,0 +1,106 @@
+#include <string>
+#include <vector>
+
+#include <catch/catch.hpp>
+
+#include "result/io.h"
+#include "result/result.h"
+#include "result/vector.h"
+
+#include "counted.h"
+
+using namespace result;
+
+namespace {
+
+using R = Result<int, std::string>;
+using V = ResultVector<int, std::string>;
+
+// Ok for every index but multiples of `error_every`, so some words of the
+// bitmap are mixed and some all Ok.
+std::vector<R> make_results(int count, int error_every) {
+    std::vector<R> results;
+    for(int i = 0; i < count; ++i) {
+        if(i % error_every == 0) {
+            results.emplace_back(err_tag, "error " + std::to_string(i));
+        } else {
+            results.emplace_back(ok_tag, i);
+        }
+    }
+    return results;
+}
+
+} // namespace
+
+TEST_CASE("ResultVector", "[vector]") {
+    SECTION("Empty") {
+        V v;
+        REQUIRE(v.empty());
+        REQUIRE(v.size() == 0);
+        REQUIRE(v.begin() == v.end());
+    }
+    SECTION("Agrees with a vector of results") {
+        auto results = make_results(300, 7);
+        V v;
+        for(const R& result : results) {
+            v.push_back(result);
+        }
+        REQUIRE(v.size() == results.size());
+        REQUIRE(v.err_count() == 43);
+        REQUIRE(v.ok_count() == 257);
+
+        for(std::size_t i = 0; i < results.size(); ++i) {
+            REQUIRE(v.is_ok(i) == results[i].is_ok());
+            if(results[i].is_ok()) {
+                REQUIRE(v[i].unwrap().get() == results[i].unwrap());
+            } else {
+                REQUIRE(v[i].unwrap_err().get() == results[i].unwrap_err());
+            }
+        }
+
+        std::size_t i = 0;
+        for(auto element : v) {
+            REQUIRE(element.is_ok() == results[i].is_ok());
+            if(element.is_ok()) {
+                REQUIRE(element.unwrap().get() == results[i].unwrap());
+            }
+            ++i;
+        }
+        REQUIRE(i == results.size());
+    }
+    SECTION("values and errors hold each kind in order") {
+        V v;
+        v.emplace_ok(1);
+        v.emplace_err("a");
+        v.emplace_ok(2);
+        v.push_back(R(err_tag, "b"));
+        REQUIRE(v.values() == std::vector<int>{1, 2});
+        REQUIRE(v.errors() == std::vector<std::string>{"a", "b"});
+    }
+    SECTION("Elements can be modified through operator[]") {
+        V v;
+        v.emplace_ok(1);
+        v.emplace_err("a");
+        v[0].unwrap().get() = 10;
+        v[1].unwrap_err().get() += "b";
+        REQUIRE(v.values() == std::vector<int>{10});
+        REQUIRE(v.errors() == std::vector<std::string>{"ab"});
+    }
+    SECTION("push_back moves from rvalues") {
+        ResultVector<Counted, Counted> v;
+        Counted::reset();
+        v.push_back(Result<Counted, Counted>(ok_tag, 1));
+        v.push_back(Result<Counted, Counted>(err_tag, 2));
+        REQUIRE(Counted::counts.copies == 0);
+        REQUIRE(v.values()[0].value == 1);
+        REQUIRE(v.errors()[0].value == 2);
+    }
+    SECTION("clear") {
+        V v;
+        v.emplace_err("a");
+        v.clear();
+        v.emplace_ok(1);
+        REQUIRE(v.size() == 1);
+        REQUIRE(v[0].unwrap().get() == 1);
+    }
+}